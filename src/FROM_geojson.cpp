@@ -26,11 +26,74 @@
 #include <fstream>
 #include <dirent.h>
 #include <map>
+#include <limits>
+#include <algorithm>
+#include <future>
+#include <functional>
+#include <cerrno>
 
 #include <R.h>
 #include <Rinternals.h>
 
 #include "json11.h"
+#include "lazy_coords.h"
+#include "simplify_geometry.h"
+#include "format_double.h"
+#include "gzip_io.h"
+#include "geojson_writer.h"
+#include "splice_features.h"
+#include "directory_walker.h"
+#include "profiler.h"
+#include "feature_stage.h"
+
+
+
+// reallocations of the Rcpp::List objects of the converters, which are counted while the json11 allocation tracking is enabled [ see 'geojsonR_alloc_stats()' ].
+// A 'push_back()' and the assignment of a new name copy the whole list to a new ( one item longer ) list
+//
+
+static double list_reallocations = 0.0, list_realloc_bytes = 0.0;
+
+
+inline void count_list_reallocation(R_xlen_t new_size) {
+
+  list_reallocations++;
+
+  list_realloc_bytes += static_cast<double>(new_size) * sizeof(SEXP);
+}
+
+
+template <typename T>
+inline void list_push_back(Rcpp::List &lst, const T &item) {
+
+  lst.push_back(item);
+
+  if (json11::alloc_tracking()) count_list_reallocation(lst.size());
+}
+
+
+// the conversion loops check for an interrupt ( and print the progress ) every 'interrupt_interval' items
+//
+
+static const int interrupt_interval = 256;
+
+
+// the Features of a 'FeatureCollection' are staged in batches of 'stage_batch' Features ( which bounds the memory of the coordinate buffers ) and each
+// OpenMP task stages 'stage_grain' consecutive Features
+//
+
+static const int stage_batch = 4096, stage_grain = 16;
+
+
+template <typename T>
+inline void list_insert(Rcpp::List &lst, const std::string &name, const T &item) {
+
+  R_xlen_t size_before = lst.size();
+
+  lst[name] = item;
+
+  if (lst.size() > size_before && json11::alloc_tracking()) count_list_reallocation(lst.size());
+}
 
 
 
@@ -42,342 +105,460 @@ class From_GeoJson_geometries {
 
 private:
 
-  arma::rowvec flatten_coords_pr;
+  double avg_sum_x, avg_comp_x, avg_sum_y, avg_comp_y;          // running (Kahan-compensated) sums of the coordinates [ 'average_coordinates' ]
 
+  unsigned long long avg_count;
 
-public:
+  bool lazy_coords;                                             // return the coordinate matrices as ALTREP objects [ see 'lazy_coords.cpp' ]
 
-  From_GeoJson_geometries() { }
+  bool feature_bbox;                                            // keep track of the bounding box of the processed positions [ 'feature_bbox' ]
 
+  double bbox_min_x, bbox_min_y, bbox_max_x, bbox_max_y;
 
-  // switch (if-else) function for the geometry-objects
+  double simplify_tolerance;                                    // Douglas-Peucker tolerance [ 0.0 : no simplification ]
+
+  int threads;                                                  // threads of the first stage of the 'FeatureCollection' conversion
+
+
+  // compensated summation of a single value [ Kahan ]
   //
 
-  Rcpp::List geom_OBJ(std::string geom_OBJECT, json11::Json input_obj, int polygon_size = 1, bool average_coordinates = false, bool to_list = false) {       // 'average_coordinates' of geojson object is needed (indirectly) in leaflet's "setView()"
+  void kahan_add(double value, double &sum, double &comp) {
 
-    Rcpp::List switch_OBJ;
+    double y = value - comp;
 
-    if (geom_OBJECT == "Point") {
+    double t = sum + y;
 
-      json11::Json::array tmp_point = input_obj["coordinates"].array_items();
+    comp = (t - sum) - y;
 
-      Rcpp::NumericVector res_point(2);                                             // in case of 'Point' by default return an Rcpp::NumericVector
+    sum = t;
+  }
 
-      res_point[0] = tmp_point[0].number_value();
 
-      res_point[1] = tmp_point[1].number_value();
+  // adds a position to the running sums of the coordinates
+  //
 
-      switch_OBJ["unlist_OBJ"] = res_point;
+  void average_add(double x, double y) {
+
+    kahan_add(x, avg_sum_x, avg_comp_x);
 
-      if (average_coordinates && !to_list) {
+    kahan_add(y, avg_sum_y, avg_comp_y);
 
-        flatten_coords_pr.set_size(2);
+    avg_count++;
+  }
 
-        flatten_coords_pr(0) = tmp_point[0].number_value();
 
-        flatten_coords_pr(1) = tmp_point[1].number_value();
-      }
+  // updates the running bounding box using the (contiguous) x and y coordinates of 'n' positions [ branch-free min / max, which the compiler can vectorize ]
+  //
+
+  void bbox_update(const double *x, const double *y, unsigned int n) {
+
+    double min_x = bbox_min_x, min_y = bbox_min_y, max_x = bbox_max_x, max_y = bbox_max_y;
+
+    for (unsigned int i = 0; i < n; i++) {
+
+      min_x = std::min(min_x, x[i]);
+
+      max_x = std::max(max_x, x[i]);
+
+      min_y = std::min(min_y, y[i]);
+
+      max_y = std::max(max_y, y[i]);
     }
 
-    else if (geom_OBJECT == "LineString" || geom_OBJECT == "MultiPoint" || (geom_OBJECT == "Polygon" && polygon_size == 1)) {
+    bbox_min_x = min_x; bbox_min_y = min_y; bbox_max_x = max_x; bbox_max_y = max_y;
+  }
 
-      json11::Json::array tmp_array;
 
-      if (geom_OBJECT == "Polygon") {
+public:
 
-        tmp_array = input_obj["coordinates"][0].array_items();}                 // array_item[0] in case of polygon-without-interior-rings
+  Phase_Profiler profiler;                                      // per-phase timing [ 'profile' = TRUE ]
 
-      if (geom_OBJECT == "LineString" || geom_OBJECT == "MultiPoint") {
+  bool verbose;                                                 // progress of the parse ( MB ) and of the conversion ( Features )
 
-        tmp_array = input_obj["coordinates"].array_items();
-      }
+  double parsed_bytes;                                          // bytes of all json data parsed by the object
+
+  From_GeoJson_geometries() : avg_sum_x(0.0), avg_comp_x(0.0), avg_sum_y(0.0), avg_comp_y(0.0), avg_count(0), lazy_coords(false), feature_bbox(false), simplify_tolerance(0.0), threads(1), verbose(false), parsed_bytes(0.0) {
+
+    reset_BBOX();
+  }
 
-      unsigned int size_array = tmp_array.size();
 
-      arma::mat tmp_RES_(size_array, 2);                                  // initialize to_list = F
+  // (lazy) ALTREP coordinate matrices [ applies only if to_list = F ]
+  //
 
-      Rcpp::List tmp_RES_LIST(size_array);                                // initialize to_list = T
+  void set_lazy_coords(bool lazy) {
 
-      for (unsigned int i = 0; i < size_array; i++) {
+    lazy_coords = lazy;
+  }
 
-        json11::Json::array inner_array = tmp_array[i].array_items();
 
-        arma::rowvec inner_vec(inner_array.size());                       // initialize to_list = F
+  // simplification of the 'LineString', 'MultiLineString', 'Polygon' and 'MultiPolygon' coordinates while they are converted
+  //
 
-        Rcpp::NumericVector res_LMP_sizeONE(2);                           // initialize to_list = T
+  void set_simplify_tolerance(double tolerance) {
 
-        for (unsigned int j = 0; j < inner_array.size(); j++) {
+    simplify_tolerance = tolerance;
+  }
 
-          if (to_list) {
 
-            res_LMP_sizeONE[j] = inner_array[j].number_value();}
+  // per-feature bounding boxes [ 'feature_bbox' ]
+  //
 
-          else {
+  void set_feature_bbox(bool bbox) {
 
-            inner_vec(j) = inner_array[j].number_value();
-          }
-        }
+    feature_bbox = bbox;
+  }
 
-        if (to_list) {
 
-          tmp_RES_LIST[i] = res_LMP_sizeONE;}
+  // number of threads of the first stage of the 'FeatureCollection' conversion [ see 'feature_stage.h' ]
+  //
 
-        else {
+  void set_threads(int threads_) {
 
-          tmp_RES_.row(i) = inner_vec;
-        }
-      }
+    threads = std::max(1, threads_);
+  }
 
-      if (average_coordinates && !to_list) {
 
-        flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(tmp_RES_, 0));
-      }
+  // progress of the parse and of the conversion [ 'verbose' ]
+  //
 
-      if (to_list) {
+  void set_verbose(bool verbose_) {
 
-        switch_OBJ["unlist_OBJ"] = tmp_RES_LIST;
-      }
+    verbose = verbose_;
+  }
 
-      else {
 
-        switch_OBJ["unlist_OBJ"] = tmp_RES_;
-      }
+  // reset the running bounding box
+  //
+
+  void reset_BBOX() {
+
+    bbox_min_x = bbox_min_y = std::numeric_limits<double>::infinity();
+
+    bbox_max_x = bbox_max_y = -std::numeric_limits<double>::infinity();
+  }
+
+
+  // return the running bounding box ( xmin, ymin, xmax, ymax ) [ NaN's if no positions were processed since the last reset ]
+  //
+
+  std::vector<double> return_BBOX() {
+
+    if (bbox_min_x > bbox_max_x) {
+
+      return std::vector<double>(4, arma::datum::nan);
     }
 
-    else if (geom_OBJECT == "MultiLineString" || (geom_OBJECT == "Polygon" && polygon_size > 1)) {
+    return {bbox_min_x, bbox_min_y, bbox_max_x, bbox_max_y};
+  }
 
-      json11::Json::array poly_tmp = input_obj["coordinates"].array_items();
 
-      unsigned int inner_poly_size = poly_tmp.size();
+  // N x 4 numeric matrix from the row-wise bounding boxes of 'N' features
+  //
+
+  Rcpp::NumericMatrix bbox_matrix(const std::vector<double> &bbox_rows) {
 
-      Rcpp::List tmp_RES_poly_interior;
+    int num_rows = bbox_rows.size() / 4;
 
-      arma::mat outer_avg;
+    Rcpp::NumericMatrix bbox_mt(num_rows, 4);
 
-      if (average_coordinates && !to_list) {
+    for (int i = 0; i < num_rows; i++) {
 
-        outer_avg.set_size(inner_poly_size, 2);
+      for (int j = 0; j < 4; j++) {
+
+        bbox_mt(i, j) = bbox_rows[4 * i + j];
       }
+    }
 
-      for (unsigned int k = 0; k < inner_poly_size; k++) {
+    Rcpp::colnames(bbox_mt) = Rcpp::CharacterVector::create("xmin", "ymin", "xmax", "ymax");
 
-        json11::Json::array tmp_array = poly_tmp[k].array_items();
+    return bbox_mt;
+  }
 
-        unsigned int size_array = tmp_array.size();
 
-        arma::mat coord_mat(size_array, 2);
+  // reset the running sums of the coordinates
+  //
 
-        Rcpp::List tmp_RES_LIST_MP(size_array);
+  void reset_COORDS() {
 
-        for (unsigned int i = 0; i < size_array; i++) {
+    avg_sum_x = avg_comp_x = avg_sum_y = avg_comp_y = 0.0;
 
-          json11::Json::array inner_array = tmp_array[i].array_items();
+    avg_count = 0;
+  }
 
-          arma::rowvec inner_vec(inner_array.size());
 
-          Rcpp::NumericVector res_LMP_sizeMULTI(2);
+  // indices of the positions which are retained after the simplification [ an empty vector if all positions are retained ]
+  //
 
-          for (unsigned int j = 0; j < inner_array.size(); j++) {
+  std::vector<int> simplify_json_positions(const json11::Json::array &tmp_array, bool ring) {
 
-            if (to_list) {
+    int n = tmp_array.size();
 
-              res_LMP_sizeMULTI[j] = inner_array[j].number_value();}
+    std::vector<double> x(n), y(n);
 
-            else {
+    for (int i = 0; i < n; i++) {
 
-              inner_vec(j) = inner_array[j].number_value();
-            }
-          }
+      x[i] = tmp_array[i][0].number_value();
 
-          if (to_list) {
+      y[i] = tmp_array[i][1].number_value();
+    }
 
-            tmp_RES_LIST_MP[i] = res_LMP_sizeMULTI;}
+    std::vector<int> keep = simplify_positions(x.data(), y.data(), n, simplify_tolerance, ring);
 
-          else {
+    if (static_cast<int>(keep.size()) == n) keep.clear();
 
-            coord_mat.row(i) = inner_vec;
-          }
-        }
+    return keep;
+  }
 
-        if (average_coordinates && !to_list) {
 
-          outer_avg.row(k) = arma::conv_to< arma::rowvec >::from(arma::mean(coord_mat, 0));
-        }
+  // the rings of a Polygon are simplified together, so that the interior rings do not intersect the exterior ring [ see 'simplify_polygon()' ]
+  //
 
-        if (to_list) {
+  std::vector<std::vector<int> > simplify_json_polygon(const json11::Json::array &poly_tmp) {
 
-          tmp_RES_poly_interior.push_back(tmp_RES_LIST_MP);}
+    std::vector<std::vector<double> > xy(poly_tmp.size());
 
-        else {
+    std::vector<const double *> x(poly_tmp.size()), y(poly_tmp.size());
 
-          tmp_RES_poly_interior.push_back(coord_mat);
-        }
-      }
+    std::vector<int> n(poly_tmp.size());
+
+    for (size_t k = 0; k < poly_tmp.size(); k++) {
+
+      const json11::Json::array &tmp_array = poly_tmp[k].array_items();
 
-      if (average_coordinates && !to_list) {
+      n[k] = tmp_array.size();
 
-        flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg, 0));
+      xy[k].resize(2 * n[k]);
+
+      for (int i = 0; i < n[k]; i++) {
+
+        xy[k][i] = tmp_array[i][0].number_value();
+
+        xy[k][n[k] + i] = tmp_array[i][1].number_value();
       }
 
-      switch_OBJ.push_back(tmp_RES_poly_interior);
+      x[k] = xy[k].data();
+
+      y[k] = xy[k].data() + n[k];
     }
 
-    else if (geom_OBJECT == "MultiPolygon") {
+    std::vector<std::vector<int> > keep = simplify_polygon(x, y, n, simplify_tolerance);
 
-      json11::Json::array tmp_mlpol = input_obj["coordinates"].array_items();
+    for (size_t k = 0; k < keep.size(); k++) {
 
-      unsigned int outer_size = tmp_mlpol.size();
+      if (static_cast<int>(keep[k].size()) == n[k]) keep[k].clear();
+    }
+
+    return keep;
+  }
 
-      arma::mat outer_avg;
 
-      if (average_coordinates && !to_list) {
+  // array of positions ( 'LineString', 'MultiPoint' or a ring of a 'Polygon' ) to a numeric matrix [ to_list = F ] or to a list of numeric vectors [ to_list = T ]
+  // the coordinates are written directly to the output object and (if 'average_coordinates' is TRUE) they are added to the running sums in the same pass
+  // if 'simplify' is TRUE ( and the 'simplify_tolerance' is greater than 0.0 ) then only the positions retained by the Douglas-Peucker algorithm are converted
+  // [ or the positions of 'ring_keep', if the ring was simplified as part of a Polygon ]
+  //
 
-        outer_avg.set_size(outer_size, 2);
-      }
+  SEXP positions_OBJ(const json11::Json::array &tmp_array, bool average_coordinates = false, bool to_list = false, bool simplify = false, bool ring = false,
 
-      for (unsigned int k = 0; k < outer_size; k++) {
+                     const std::vector<int> *ring_keep = NULL) {
 
-        json11::Json array_item = tmp_mlpol[k];
+    unsigned int size_array = tmp_array.size();
 
-        int tmp_size_array = array_item.array_items().size();
+    std::vector<int> keep;
 
-        if (tmp_size_array == 1) {
+    if (ring_keep != NULL) {
 
-          json11::Json::array tmp_array = array_item[0].array_items();                         // array_item[0] in case of polygon-without-interior-rings  [ multi-polygon --version ]
+      keep = *ring_keep;}
 
-          unsigned int size_array = tmp_array.size();
+    else if (simplify && simplify_tolerance > 0.0) {
 
-          arma::mat tmp_RES_(size_array, 2);
+      keep = simplify_json_positions(tmp_array, ring);
+    }
 
-          Rcpp::List tmp_RES_LIST_MPoly(size_array);
+    if (!keep.empty()) size_array = keep.size();
 
-          for (unsigned int i = 0; i < size_array; i++) {
+    auto position = [&tmp_array, &keep](unsigned int i) -> const json11::Json & { return keep.empty() ? tmp_array[i] : tmp_array[keep[i]]; };
 
-            json11::Json::array inner_array = tmp_array[i].array_items();
+    if (to_list) {
 
-            arma::rowvec inner_vec(inner_array.size());
+      Rcpp::List tmp_RES_LIST(size_array);
 
-            Rcpp::NumericVector res_MPoly(2);
+      for (unsigned int i = 0; i < size_array; i++) {
 
-            for (unsigned int j = 0; j < inner_array.size(); j++) {
+        Rcpp::NumericVector res_LMP(2);
 
-              if (to_list) {
+        res_LMP[0] = position(i)[0].number_value();
 
-                res_MPoly[j] = inner_array[j].number_value();}
+        res_LMP[1] = position(i)[1].number_value();
 
-              else {
+        tmp_RES_LIST[i] = res_LMP;
 
-                inner_vec(j) = inner_array[j].number_value();
-              }
-            }
+        if (feature_bbox) {
 
-            if (to_list) {
+          double x = res_LMP[0], y = res_LMP[1];
 
-              tmp_RES_LIST_MPoly[i] = res_MPoly;}
+          bbox_update(&x, &y, 1);
+        }
+      }
 
-            else {
+      return tmp_RES_LIST;
+    }
 
-              tmp_RES_.row(i) = inner_vec;
-            }
-          }
+    if (lazy_coords) {
 
-          if (average_coordinates && !to_list) {
+      std::vector<double> coords_buf(2 * size_array);                       // column-major buffer which is retained by the ALTREP object
 
-            outer_avg.row(k) = arma::conv_to< arma::rowvec >::from(arma::mean(tmp_RES_, 0));
-          }
+      for (unsigned int i = 0; i < size_array; i++) {
 
-          if (to_list) {
+        double x = position(i)[0].number_value();
 
-            switch_OBJ.push_back(tmp_RES_LIST_MPoly);}
+        double y = position(i)[1].number_value();
 
-          else {
+        coords_buf[i] = x;
 
-            switch_OBJ.push_back(tmp_RES_);
-          }
+        coords_buf[size_array + i] = y;
+
+        if (average_coordinates) {
+
+          average_add(x, y);
         }
+      }
 
-        if (tmp_size_array > 1) {
+      if (feature_bbox) {
 
-          json11::Json::array poly_tmp = array_item.array_items();                             // multi-polygon [ polygon WITH interior --version ]
+        bbox_update(coords_buf.data(), coords_buf.data() + size_array, size_array);
+      }
 
-          unsigned int inner_poly_size = poly_tmp.size();
+      return lazy_coords_matrix(std::move(coords_buf), size_array, 2);
+    }
 
-          Rcpp::List tmp_RES_poly_interior;
+    Rcpp::NumericMatrix tmp_RES_(size_array, 2);
 
-          arma::mat outer_avg_sec;
+    for (unsigned int i = 0; i < size_array; i++) {
 
-          if (average_coordinates && !to_list) {
+      double x = position(i)[0].number_value();
 
-            outer_avg_sec.set_size(inner_poly_size, 2);
-          }
+      double y = position(i)[1].number_value();
 
-          for (unsigned int k1 = 0; k1 < inner_poly_size; k1++) {
+      tmp_RES_(i, 0) = x;
+
+      tmp_RES_(i, 1) = y;
+
+      if (average_coordinates) {
+
+        average_add(x, y);
+      }
+    }
 
-            json11::Json::array tmp_array = poly_tmp[k1].array_items();
+    if (feature_bbox) {
+
+      bbox_update(tmp_RES_.begin(), tmp_RES_.begin() + size_array, size_array);          // column-major, thus the x and y coordinates are contiguous
+    }
 
-            unsigned int size_array = tmp_array.size();
+    return tmp_RES_;
+  }
 
-            arma::mat coord_mat(size_array, 2);
 
-            Rcpp::List tmp_RES_LIST_MPolyMULTI(size_array);
+  // switch (if-else) function for the geometry-objects
+  //
 
-            for (unsigned int i = 0; i < size_array; i++) {
+  Rcpp::List geom_OBJ(std::string geom_OBJECT, json11::Json input_obj, int polygon_size = 1, bool average_coordinates = false, bool to_list = false) {       // 'average_coordinates' of geojson object is needed (indirectly) in leaflet's "setView()"
 
-              json11::Json::array inner_array = tmp_array[i].array_items();
+    Rcpp::List switch_OBJ;
 
-              arma::rowvec inner_vec(inner_array.size());
+    bool avg_coords = average_coordinates && !to_list;
 
-              Rcpp::NumericVector res_MPolyMULTI(2);
+    if (geom_OBJECT == "Point") {
 
-              for (unsigned int j = 0; j < inner_array.size(); j++) {
+      const json11::Json::array &tmp_point = input_obj["coordinates"].array_items();
 
-                if (to_list) {
+      Rcpp::NumericVector res_point(2);                                             // in case of 'Point' by default return an Rcpp::NumericVector
 
-                  res_MPolyMULTI[j] = inner_array[j].number_value();}
+      res_point[0] = tmp_point[0].number_value();
 
-                else {
+      res_point[1] = tmp_point[1].number_value();
 
-                  inner_vec(j) = inner_array[j].number_value();
-                }
-              }
+      switch_OBJ["unlist_OBJ"] = res_point;
 
-              if (to_list) {
+      if (avg_coords) {
 
-                tmp_RES_LIST_MPolyMULTI[i] = res_MPolyMULTI;}
+        average_add(res_point[0], res_point[1]);
+      }
 
-              else {
+      if (feature_bbox) {
 
-                coord_mat.row(i) = inner_vec;
-              }
-            }
+        double x = res_point[0], y = res_point[1];
 
-            if (average_coordinates && !to_list) {
+        bbox_update(&x, &y, 1);
+      }
+    }
 
-              outer_avg_sec.row(k1) = arma::conv_to< arma::rowvec >::from(arma::mean(coord_mat, 0));
-            }
+    else if (geom_OBJECT == "LineString" || geom_OBJECT == "MultiPoint" || (geom_OBJECT == "Polygon" && polygon_size == 1)) {
 
-            if (to_list) {
+      if (geom_OBJECT == "Polygon") {
 
-              tmp_RES_poly_interior.push_back(tmp_RES_LIST_MPolyMULTI);}
+        switch_OBJ["unlist_OBJ"] = positions_OBJ(input_obj["coordinates"][0].array_items(), avg_coords, to_list, true, true);}        // array_item[0] in case of polygon-without-interior-rings
 
-            else {
+      else {
 
-              tmp_RES_poly_interior.push_back(coord_mat);
-            }
-          }
+        switch_OBJ["unlist_OBJ"] = positions_OBJ(input_obj["coordinates"].array_items(), avg_coords, to_list, geom_OBJECT == "LineString", false);
+      }
+    }
 
-          if (average_coordinates && !to_list) {
+    else if (geom_OBJECT == "MultiLineString" || (geom_OBJECT == "Polygon" && polygon_size > 1)) {
 
-            outer_avg.row(k) = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg_sec, 0));
-          }
+      const json11::Json::array &poly_tmp = input_obj["coordinates"].array_items();
 
-          switch_OBJ.push_back(tmp_RES_poly_interior);
-        }
+      unsigned int inner_poly_size = poly_tmp.size();
+
+      Rcpp::List tmp_RES_poly_interior(inner_poly_size);
+
+      std::vector<std::vector<int> > rings_keep;
+
+      if (geom_OBJECT == "Polygon" && simplify_tolerance > 0.0) rings_keep = simplify_json_polygon(poly_tmp);
+
+      for (unsigned int k = 0; k < inner_poly_size; k++) {
+
+        tmp_RES_poly_interior[k] = positions_OBJ(poly_tmp[k].array_items(), avg_coords, to_list, true, geom_OBJECT == "Polygon", rings_keep.empty() ? NULL : &rings_keep[k]);
       }
 
-      if (average_coordinates && !to_list) {
+      list_push_back(switch_OBJ, tmp_RES_poly_interior);
+    }
+
+    else if (geom_OBJECT == "MultiPolygon") {
+
+      const json11::Json::array &tmp_mlpol = input_obj["coordinates"].array_items();
+
+      unsigned int outer_size = tmp_mlpol.size();
+
+      for (unsigned int k = 0; k < outer_size; k++) {
+
+        const json11::Json::array &poly_tmp = tmp_mlpol[k].array_items();
+
+        unsigned int inner_poly_size = poly_tmp.size();
 
-        flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg, 0));
+        if (inner_poly_size == 1) {
+
+          list_push_back(switch_OBJ, positions_OBJ(poly_tmp[0].array_items(), avg_coords, to_list, true, true));                  // array_item[0] in case of polygon-without-interior-rings  [ multi-polygon --version ]
+        }
+
+        if (inner_poly_size > 1) {
+
+          Rcpp::List tmp_RES_poly_interior(inner_poly_size);                                                     // multi-polygon [ polygon WITH interior --version ]
+
+          std::vector<std::vector<int> > rings_keep;
+
+          if (simplify_tolerance > 0.0) rings_keep = simplify_json_polygon(poly_tmp);
+
+          for (unsigned int k1 = 0; k1 < inner_poly_size; k1++) {
+
+            tmp_RES_poly_interior[k1] = positions_OBJ(poly_tmp[k1].array_items(), avg_coords, to_list, true, true, rings_keep.empty() ? NULL : &rings_keep[k1]);
+          }
+
+          list_push_back(switch_OBJ, tmp_RES_poly_interior);
+        }
       }
     }
 
@@ -390,11 +571,24 @@ public:
   }
 
 
-  // return average_coordinates
+  // return average_coordinates [ the mean of all positions that were processed since the last reset ]
   //
 
   arma::rowvec return_COORDS() {
 
+    arma::rowvec flatten_coords_pr(2);
+
+    if (avg_count == 0) {
+
+      flatten_coords_pr.fill(arma::datum::nan);}
+
+    else {
+
+      flatten_coords_pr(0) = (avg_sum_x - avg_comp_x) / avg_count;
+
+      flatten_coords_pr(1) = (avg_sum_y - avg_comp_y) / avg_count;
+    }
+
     return flatten_coords_pr;
   }
 
@@ -408,19 +602,12 @@ public:
 
     json11::Json::array col_array = parse_geom["geometries"].array_items();
 
-    RES_col["type"] = parse_geom["type"].string_value();
+    list_insert(RES_col, "type", parse_geom["type"].string_value());
 
     unsigned int SIZE = col_array.size();
 
     Rcpp::List geoms_tmp;
 
-    arma::mat outer_avg;
-
-    if (average_coordinates && !to_list) {
-
-      outer_avg.set_size(SIZE, 2);
-    }
-
     for (unsigned int f = 0; f < SIZE; f++) {
 
       json11::Json iter = col_array[f];
@@ -429,36 +616,24 @@ public:
 
       Rcpp::List RES_inner;
 
-      RES_inner["type"] = res_type;
+      list_insert(RES_inner, "type", res_type);
 
       int polygon_size = iter["coordinates"].array_items().size();
 
       if (res_type == "Point" || res_type == "LineString" || res_type == "MultiPoint" || (res_type == "Polygon" && polygon_size == 1)) {
 
-        RES_inner["coordinates"] = geom_OBJ(res_type, iter, polygon_size, average_coordinates, to_list)["unlist_OBJ"];         // unlist object
+        list_insert(RES_inner, "coordinates", geom_OBJ(res_type, iter, polygon_size, average_coordinates, to_list)["unlist_OBJ"]);         // unlist object
       }
 
       else {
 
-        RES_inner["coordinates"] = geom_OBJ(res_type, iter, polygon_size, average_coordinates, to_list);
-      }
-
-      if (average_coordinates && !to_list) {
-
-        outer_avg.row(f) = flatten_coords_pr;
-
-        flatten_coords_pr.clear();                  // each time it's called : it first assigns to arma::mat then clears the private-variable [ due to "inside-class-loop" ]
+        list_insert(RES_inner, "coordinates", geom_OBJ(res_type, iter, polygon_size, average_coordinates, to_list));
       }
 
-      geoms_tmp.push_back(RES_inner);
-    }
-
-    if (average_coordinates && !to_list) {
-
-      flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg, 0));
+      list_push_back(geoms_tmp, RES_inner);                 // the positions of each geometry are added to the running sums of the coordinates [ 'average_coordinates' ]
     }
 
-    RES_col["geometries"] = geoms_tmp;
+    list_insert(RES_col, "geometries", geoms_tmp);
 
     return RES_col;
   }
@@ -492,7 +667,7 @@ public:
 
       for (auto& second_item : json.array_items()) {
 
-        recurs_out_array.push_back(Rcpp::wrap(recursive_switch(second_item)));          // recursion of 'arrays' for geojson files is limited only to the "properties" member (unknown depth of array AND unknown type of item of each array). This because recursion is slower than a for loop
+        list_push_back(recurs_out_array, Rcpp::wrap(recursive_switch(second_item)));          // recursion of 'arrays' for geojson files is limited only to the "properties" member (unknown depth of array AND unknown type of item of each array). This because recursion is slower than a for loop
       }
 
       return recurs_out_array;
@@ -506,7 +681,7 @@ public:
 
         std::string SEC_ITEM = second_item.first;
 
-        recurs_out[SEC_ITEM] = Rcpp::wrap(recursive_switch(json[SEC_ITEM]));             // recursion for properties [ unknown depth ]
+        list_insert(recurs_out, SEC_ITEM, Rcpp::wrap(recursive_switch(json[SEC_ITEM])));             // recursion for properties [ unknown depth ]
       }
 
       return recurs_out;
@@ -530,17 +705,17 @@ public:
 
       if (iter.first == "type") {
 
-        RES_feat["type"] = iter.second.string_value();}
+        list_insert(RES_feat, "type", iter.second.string_value());}
 
       else if (iter.first == "id" || iter.first == "_id") {                 // exception : some geojson feature-files have the 'id' member with an underscore [ in any case create an 'id' in the resulted list ]
 
         if (iter.second.is_number()) {
 
-          RES_feat["id"] = iter.second.number_value();}
+          list_insert(RES_feat, "id", iter.second.number_value());}
 
         else if (iter.second.is_string()) {
 
-          RES_feat["id"] = iter.second.string_value();}
+          list_insert(RES_feat, "id", iter.second.string_value());}
 
         else {
 
@@ -559,7 +734,7 @@ public:
           bbox_vec.push_back(it.number_value());
         }
 
-        RES_feat["bbox"] = bbox_vec;
+        list_insert(RES_feat, "bbox", bbox_vec);
       }
 
       else if (iter.first == "geometry") {
@@ -572,18 +747,18 @@ public:
 
         Rcpp::List RES_OUT_feat;
 
-        RES_OUT_feat["type"] = res_type;
+        list_insert(RES_OUT_feat, "type", res_type);
 
         if (res_type == "Point" || res_type == "LineString" || res_type == "MultiPoint" || (res_type == "Polygon" && polygon_size == 1)) {
 
-          RES_OUT_feat["coordinates"] = geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list)["unlist_OBJ"];}                           // unlist object
+          list_insert(RES_OUT_feat, "coordinates", geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list)["unlist_OBJ"]);}                           // unlist object
 
         else {
 
-          RES_OUT_feat["coordinates"] = geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list);
+          list_insert(RES_OUT_feat, "coordinates", geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list));
         }
 
-        RES_feat["geometry"] = RES_OUT_feat;
+        list_insert(RES_feat, "geometry", RES_OUT_feat);
       }
 
       else if (iter.first == "properties" && !flatten_coords) {
@@ -594,10 +769,10 @@ public:
 
           std::string first_item = item_prop.first;
 
-          tmp_prop[first_item] = recursive_switch(input_obj["properties"][first_item]);
+          list_insert(tmp_prop, first_item, recursive_switch(input_obj["properties"][first_item]));
         }
 
-        RES_feat["properties"] = tmp_prop;
+        list_insert(RES_feat, "properties", tmp_prop);
       }
     }
 
@@ -606,42 +781,243 @@ public:
 
 
 
-  // geojson object : "Feature"  [ used in the 'schema' function ]
+  // staged positions to a numeric matrix [ to_list = F ] or to a list of numeric vectors [ to_list = T ], the same output as the 'positions_OBJ()' function
   //
 
-  Rcpp::List feature_OBJ_schema(json11::Json input_obj, bool average_coordinates = false, bool to_list = false) {     // 'flatten_coords' and 'average_coordinates' of geojson object is needed (indirectly) in leaflet's "setView()"
+  SEXP stage_positions_OBJ(Stage_Positions &xy, bool avg_coords = false, bool to_list = false) {
 
-    Rcpp::List RES_feat;
+    unsigned int size_array = xy.size() / 2;
 
-    for (auto& iter : input_obj.object_items()) {
+    if (avg_coords) {
 
-      if (iter.first == "geometry") {                                                           // In 'Feature' the property-name of each geometry-object is 'geometry'
+      for (unsigned int i = 0; i < size_array; i++) {
 
-        json11::Json tmp_geom = input_obj["geometry"];
+        average_add(xy[i], xy[size_array + i]);
+      }
+    }
 
-        std::string res_type = tmp_geom["type"].string_value();
+    if (to_list) {
 
-        int polygon_size = tmp_geom["coordinates"].array_items().size();
+      Rcpp::List tmp_RES_LIST(size_array);
 
-        Rcpp::List RES_OUT_feat;
+      for (unsigned int i = 0; i < size_array; i++) {
 
-        RES_OUT_feat["type"] = res_type;
+        tmp_RES_LIST[i] = Rcpp::NumericVector::create(xy[i], xy[size_array + i]);
+      }
 
-        if (res_type == "Point" || res_type == "LineString" || res_type == "MultiPoint" || (res_type == "Polygon" && polygon_size == 1)) {
+      return tmp_RES_LIST;
+    }
+
+    if (lazy_coords) {
+
+      return lazy_coords_matrix(std::move(xy), size_array, 2);
+    }
+
+    Rcpp::NumericMatrix tmp_RES_(size_array, 2);
+
+    std::copy(xy.begin(), xy.end(), tmp_RES_.begin());
+
+    return tmp_RES_;
+  }
+
+
+  // staged geometry to the "coordinates" of the output, the same as the ( unlisted ) output of the 'geom_OBJ()' function
+  //
+
+  SEXP stage_geometry_OBJ(Stage_Geometry &geom, bool average_coordinates = false, bool to_list = false) {
+
+    bool avg_coords = average_coordinates && !to_list;
+
+    if (geom.layout == STAGE_POINT) {
+
+      Rcpp::NumericVector res_point = Rcpp::NumericVector::create(geom.parts[0][0], geom.parts[0][1]);
+
+      if (avg_coords) {
+
+        average_add(res_point[0], res_point[1]);
+      }
+
+      return res_point;
+    }
+
+    if (geom.layout == STAGE_POSITIONS) {
+
+      return stage_positions_OBJ(geom.parts[0], avg_coords, to_list);
+    }
+
+    if (geom.layout == STAGE_RINGS) {
+
+      Rcpp::List tmp_RES_poly_interior(geom.parts.size());
+
+      for (unsigned int k = 0; k < geom.parts.size(); k++) {
+
+        tmp_RES_poly_interior[k] = stage_positions_OBJ(geom.parts[k], avg_coords, to_list);
+      }
+
+      return Rcpp::List::create(tmp_RES_poly_interior);
+    }
+
+    Rcpp::List switch_OBJ(geom.rings.size());                                                            // 'STAGE_MULTI'
+
+    unsigned int part = 0;
+
+    for (unsigned int k = 0; k < geom.rings.size(); k++) {
+
+      if (geom.rings[k] == 1) {
+
+        switch_OBJ[k] = stage_positions_OBJ(geom.parts[part++], avg_coords, to_list);}
+
+      else {
+
+        Rcpp::List tmp_RES_poly_interior(geom.rings[k]);
+
+        for (int k1 = 0; k1 < geom.rings[k]; k1++) {
+
+          tmp_RES_poly_interior[k1] = stage_positions_OBJ(geom.parts[part++], avg_coords, to_list);
+        }
+
+        switch_OBJ[k] = tmp_RES_poly_interior;
+      }
+    }
+
+    return switch_OBJ;
+  }
+
+
+  // staged Feature to the same output as the 'feature_OBJ()' function. The lists are allocated once with their final size
+  //
+
+  Rcpp::List stage_feature_OBJ(Stage_Feature &feat, bool average_coordinates = false, bool to_list = false) {
+
+    int num_members = feat.members.size();
+
+    Rcpp::List RES_feat(num_members);
+
+    Rcpp::CharacterVector nams(num_members);
+
+    for (int m = 0; m < num_members; m++) {
+
+      switch (feat.members[m]) {
 
-          RES_OUT_feat["coordinates"] = geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list)["unlist_OBJ"];}                           // unlist object
+        case MEMBER_TYPE: {
+
+          nams[m] = "type";
+
+          RES_feat[m] = Rcpp::wrap(*feat.type);
+
+          break;
+        }
+
+        case MEMBER_ID: {
+
+          nams[m] = "id";
+
+          RES_feat[m] = feat.id_number ? Rcpp::wrap(feat.id_value) : Rcpp::wrap(*feat.id_string);
+
+          break;
+        }
+
+        case MEMBER_BBOX: {
+
+          nams[m] = "bbox";
+
+          RES_feat[m] = Rcpp::wrap(feat.bbox);
+
+          break;
+        }
+
+        case MEMBER_GEOMETRY: {
+
+          nams[m] = "geometry";
+
+          RES_feat[m] = Rcpp::List::create(Rcpp::Named("type") = *feat.geometry.type,
+
+                                           Rcpp::Named("coordinates") = stage_geometry_OBJ(feat.geometry, average_coordinates, to_list));
+
+          break;
+        }
+
+        case MEMBER_PROPERTIES: {
+
+          nams[m] = "properties";
+
+          int num_props = feat.properties.size();
+
+          Rcpp::List tmp_prop(num_props);
+
+          Rcpp::CharacterVector nams_prop(num_props);
+
+          for (int k = 0; k < num_props; k++) {
+
+            const Stage_Property &prop = feat.properties[k];
+
+            nams_prop[k] = *prop.name;
+
+            switch (prop.type) {
+
+              case json11::Json::NUL: break;                                                               // the items of the list are initialized to NULL
+
+              case json11::Json::NUMBER: tmp_prop[k] = Rcpp::wrap(prop.number); break;
+
+              case json11::Json::BOOL: tmp_prop[k] = Rcpp::wrap(prop.number != 0.0); break;
+
+              case json11::Json::STRING: tmp_prop[k] = Rcpp::wrap(prop.value->string_value()); break;
+
+              default: tmp_prop[k] = recursive_switch(*prop.value);                                        // arrays and objects
+            }
+          }
+
+          if (num_props > 0) tmp_prop.names() = nams_prop;
+
+          RES_feat[m] = tmp_prop;
+
+          break;
+        }
+      }
+    }
+
+    if (num_members > 0) RES_feat.names() = nams;
+
+    return RES_feat;
+  }
+
+
+  // geojson object : "Feature"  [ used in the 'schema' function ]
+  //
+
+  Rcpp::List feature_OBJ_schema(json11::Json input_obj, bool average_coordinates = false, bool to_list = false) {     // 'flatten_coords' and 'average_coordinates' of geojson object is needed (indirectly) in leaflet's "setView()"
+
+    Rcpp::List RES_feat;
+
+    for (auto& iter : input_obj.object_items()) {
+
+      if (iter.first == "geometry") {                                                           // In 'Feature' the property-name of each geometry-object is 'geometry'
+
+        json11::Json tmp_geom = input_obj["geometry"];
+
+        std::string res_type = tmp_geom["type"].string_value();
+
+        int polygon_size = tmp_geom["coordinates"].array_items().size();
+
+        Rcpp::List RES_OUT_feat;
+
+        list_insert(RES_OUT_feat, "type", res_type);
+
+        if (res_type == "Point" || res_type == "LineString" || res_type == "MultiPoint" || (res_type == "Polygon" && polygon_size == 1)) {
+
+          list_insert(RES_OUT_feat, "coordinates", geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list)["unlist_OBJ"]);}                           // unlist object
 
         else {
 
-          RES_OUT_feat["coordinates"] = geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list);
+          list_insert(RES_OUT_feat, "coordinates", geom_OBJ(res_type, tmp_geom, polygon_size, average_coordinates, to_list));
         }
 
-        RES_feat["geometry"] = RES_OUT_feat;
+        list_insert(RES_feat, "geometry", RES_OUT_feat);
       }
 
       else {
 
-        RES_feat[iter.first] = recursive_switch(iter.second);
+        list_insert(RES_feat, iter.first, recursive_switch(iter.second));
       }
     }
 
@@ -660,7 +1036,7 @@ public:
 
       if (iter.first == "type") {
 
-        RES_feat_col["type"] = iter.second.string_value();}
+        list_insert(RES_feat_col, "type", iter.second.string_value());}
 
       else if (iter.first == "bbox") {
 
@@ -671,44 +1047,118 @@ public:
           bbox_vec.push_back(num.number_value());
         }
 
-        RES_feat_col["bbox"] = bbox_vec;
+        list_insert(RES_feat_col, "bbox", bbox_vec);
       }
 
       else if (iter.first == "features") {
 
         Rcpp::List lst_feats;
 
-        json11::Json::array tmp_arr = input_obj["features"].array_items();
-
-        unsigned int ITER_AVG = 0;
+        const json11::Json::array &tmp_arr = input_obj["features"].array_items();
 
-        arma::mat outer_avg;
+        std::vector<double> bbox_rows;
 
-        if (average_coordinates && !to_list) {
+        if (feature_bbox) {
 
-          outer_avg.set_size(tmp_arr.size(), 2);
+          bbox_rows.reserve(4 * tmp_arr.size());
         }
 
-        for (auto& itf : tmp_arr) {
+        int num_feats = tmp_arr.size();
 
-          lst_feats.push_back(feature_OBJ(itf, flatten_coords, average_coordinates, to_list));
+        lst_feats = Rcpp::List(num_feats);
 
-          if (average_coordinates && !to_list) {
+        Feature_Stager stager(flatten_coords, simplify_tolerance, feature_bbox);
 
-            outer_avg.row(ITER_AVG) = flatten_coords_pr;
+        for (int b = 0; b < num_feats; b += stage_batch) {                            // two stages : the Features of a batch are staged in parallel ( OpenMP tasks of 'stage_grain' Features,
+                                                                                      // which the idle threads take over, thus a single large Feature does not delay the other Features )
+          int b_end = std::min(b + stage_batch, num_feats);                           // and then the R objects are allocated in the main thread, because the R API is single-threaded
 
-            flatten_coords_pr.clear();                       // each time it's called : it first assigns to arma::mat then clears the private-variable [ due to "inside-class-loop" ]
+          std::vector<Stage_Feature> staged(b_end - b);
 
-            ITER_AVG++;
+          #ifdef _OPENMP
+          #pragma omp parallel num_threads(threads) if(threads > 1)
+          #pragma omp single
+          #endif
+          {
+            for (int t = b; t < b_end; t += stage_grain) {
+
+              #ifdef _OPENMP
+              #pragma omp task firstprivate(t)
+              #endif
+              {
+                int t_end = std::min(t + stage_grain, b_end);
+
+                for (int i = t; i < t_end; i++) stager.stage(tmp_arr[i], staged[i - b]);
+              }
+            }
           }
-        }
 
-        if (average_coordinates && !to_list) {
+          for (int i = b; i < b_end; i++) {
+
+            if ((i + 1) % interrupt_interval == 0) {
+
+              if (verbose) Rprintf("\rconverted Features: %d of %d", i + 1, num_feats);
+
+              Rcpp::checkUserInterrupt();                                             // the staged Features are released during the unwinding
+            }
 
-          flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg, 0));
+            Stage_Feature &feat = staged[i - b];
+
+            if (!feat.error.empty()) Rcpp::stop(feat.error);
+
+            lst_feats[i] = stage_feature_OBJ(feat, average_coordinates, to_list);
+
+            if (feature_bbox) {
+
+              if (feat.feature_bbox[0] > feat.feature_bbox[2]) {                      // no positions
+
+                bbox_rows.insert(bbox_rows.end(), 4, arma::datum::nan);}
+
+              else {
+
+                bbox_rows.insert(bbox_rows.end(), feat.feature_bbox, feat.feature_bbox + 4);
+              }
+            }
+
+            feat = Stage_Feature();                                                   // release the coordinate buffers as soon as the Feature is converted
+          }
         }
 
-        RES_feat_col["features"] = lst_feats;
+        if (verbose) Rprintf("\rconverted Features: %d of %d\n", num_feats, num_feats);
+
+        list_insert(RES_feat_col, "features", lst_feats);
+
+        if (feature_bbox) {
+
+          list_insert(RES_feat_col, "feature_bbox", bbox_matrix(bbox_rows));
+
+          if (input_obj["bbox"].is_null()) {                                          // fill the 'FeatureCollection' bbox if the source does not provide one
+
+            std::vector<double> coll_bbox = {arma::datum::nan, arma::datum::nan, arma::datum::nan, arma::datum::nan};
+
+            for (unsigned int i = 0; i < bbox_rows.size(); i += 4) {
+
+              if (bbox_rows[i] != bbox_rows[i]) continue;                             // skip features without positions ( NaN )
+
+              if (coll_bbox[0] != coll_bbox[0]) {
+
+                coll_bbox.assign(bbox_rows.begin() + i, bbox_rows.begin() + i + 4);}
+
+              else {
+
+                coll_bbox[0] = std::min(coll_bbox[0], bbox_rows[i]);
+
+                coll_bbox[1] = std::min(coll_bbox[1], bbox_rows[i + 1]);
+
+                coll_bbox[2] = std::max(coll_bbox[2], bbox_rows[i + 2]);
+
+                coll_bbox[3] = std::max(coll_bbox[3], bbox_rows[i + 3]);
+              }
+            }
+
+            list_insert(RES_feat_col, "bbox", coll_bbox);
+          }
+        }
       }
     }
 
@@ -730,42 +1180,30 @@ public:
 
         Rcpp::List lst_feats;
 
-        json11::Json::array tmp_arr = input_obj["features"].array_items();
-
-        unsigned int ITER_AVG = 0;
-
-        arma::mat outer_avg;
+        const json11::Json::array &tmp_arr = input_obj["features"].array_items();
 
-        if (average_coordinates && !to_list) {
-
-          outer_avg.set_size(tmp_arr.size(), 2);
-        }
+        int num_feats = tmp_arr.size(), feat_idx = 0;
 
         for (auto& itf : tmp_arr) {
 
-          lst_feats.push_back(feature_OBJ_schema(itf, average_coordinates, to_list));        // In 'FeatureCollection' the property-name of each geometry-object is 'geometry'
-
-          if (average_coordinates && !to_list) {
+          if (++feat_idx % interrupt_interval == 0) {
 
-            outer_avg.row(ITER_AVG) = flatten_coords_pr;
+            if (verbose) Rprintf("\rconverted Features: %d of %d", feat_idx, num_feats);
 
-            flatten_coords_pr.clear();                       // each time it's called : it first assigns to arma::mat then clears the private-variable [ due to "inside-class-loop" ]
-
-            ITER_AVG++;
+            Rcpp::checkUserInterrupt();
           }
-        }
-
-        if (average_coordinates && !to_list) {
 
-          flatten_coords_pr = arma::conv_to< arma::rowvec >::from(arma::mean(outer_avg, 0));
+          list_push_back(lst_feats, feature_OBJ_schema(itf, average_coordinates, to_list));        // In 'FeatureCollection' the property-name of each geometry-object is 'geometry'
         }
 
-        RES_feat_col[iter.first] = lst_feats;
+        if (verbose) Rprintf("\rconverted Features: %d of %d\n", num_feats, num_feats);
+
+        list_insert(RES_feat_col, iter.first, lst_feats);
       }
 
       else {
 
-        RES_feat_col[iter.first] = recursive_switch(iter.second);
+        list_insert(RES_feat_col, iter.first, recursive_switch(iter.second));
       }
     }
 
@@ -785,6 +1223,43 @@ public:
   }
 
 
+  // read the content of a file in a single (bulk) read OR inflate it if it's gzip-compressed [ it does not use the R API, thus it can be called from multiple threads ]
+  //
+
+  bool read_geojson_file(const std::string &input_data, std::string &data_in) {
+
+    return read_file_contents(input_data, data_in);
+  }
+
+
+  // parse of the json data in the main thread, which can be interrupted by the user ( every 4 MB ). If 'verbose' is true then the progress is printed
+  //
+
+  json11::Json parse_interruptible(const std::string &data_in, std::string &Error_Message) {
+
+    json11::ParseProgress progress;
+
+    progress.interval = 1 << 22;
+
+    progress.callback = [&](size_t position, size_t total) {
+
+      if (verbose) Rprintf("\rparsed: %.1f of %.1f MB", position / 1048576.0, total / 1048576.0);
+
+      Rcpp::checkUserInterrupt();                                  // the exception unwinds the (partially) parsed json11 objects
+
+      return true;
+    };
+
+    json11::Json json_input = json11::Json::parse(data_in, Error_Message, json11::JsonParse::COMMENTS, progress);
+
+    parsed_bytes += data_in.size();
+
+    if (verbose && data_in.size() >= progress.interval) Rprintf("\rparsed: %.1f of %.1f MB\n", data_in.size() / 1048576.0, data_in.size() / 1048576.0);
+
+    return json_input;
+  }
+
+
   // parse the geo-json objects
   //
 
@@ -797,18 +1272,24 @@ public:
 
     std::string data_in;
 
-    std::fstream myfile(input_data, std::fstream::in);
-
-    char chs;
+    profiler.start("file read");
 
-    while (myfile >> std::noskipws >> chs) {
+    if (!read_geojson_file(input_data, data_in)) {
 
-      data_in += chs;
+      Rcpp::stop("the input file '" + input_data + "' can not be read ( or the gzip-compressed data are invalid )!");
     }
 
+    profiler.stop(data_in.size());
+
     std::string Error_Message;
 
-    json11::Json json_input = json11::Json::parse(data_in, Error_Message, json11::JsonParse::COMMENTS);
+    profiler.start("JSON parse");
+
+    json11::Json json_input = parse_interruptible(data_in, Error_Message);
+
+    profiler.stop(data_in.size());
+
+    profiler.count_json_nodes(json_input);
 
     if (json_input.is_null()) {
 
@@ -831,7 +1312,13 @@ public:
 
     std::string Error_Message;
 
-    json11::Json json_input = json11::Json::parse(character_string, Error_Message, json11::JsonParse::COMMENTS);
+    profiler.start("JSON parse");
+
+    json11::Json json_input = parse_interruptible(character_string, Error_Message);
+
+    profiler.stop(character_string.size());
+
+    profiler.count_json_nodes(json_input);
 
     if (json_input.is_null()) {
 
@@ -852,7 +1339,7 @@ public:
 
   Rcpp::List helper_geom_objects(From_GeoJson_geometries prs, json11::Json tmp_prs, bool flatten_coords = false,
 
-                                 bool average_coordinates = false, bool schema = false, bool to_list = false) {
+                                 bool average_coordinates = false, bool schema = false, bool to_list = false, bool geometry_dump = true) {
 
     Rcpp::List RES_OUT;
 
@@ -873,6 +1360,11 @@ public:
       else {
 
         RES_OUT = prs.feature_OBJ(tmp_prs, flatten_coords, average_coordinates, to_list);                      // setting 'flatten_coords' to TRUE avoids 'properties' member recursive calculation
+
+        if (prs.feature_bbox) {
+
+          RES_OUT["feature_bbox"] = prs.bbox_matrix(prs.return_BBOX());                                        // 1 x 4 matrix
+        }
       }
     }
 
@@ -907,7 +1399,10 @@ public:
 
     if (average_coordinates && !to_list) {
 
-      RES_OUT["geometry_dump"] = tmp_prs.dump();
+      if (geometry_dump) {
+
+        RES_OUT["geometry_dump"] = tmp_prs.dump(prs.threads);             // optional, because it re-serializes the whole input [ the large arrays in parallel ]
+      }
 
       RES_OUT["leaflet_view_coords"] = prs.return_COORDS();
     }
@@ -936,10 +1431,24 @@ public:
 //
 
 // [[Rcpp::export]]
-Rcpp::List export_From_geojson(std::string input_file, bool flatten_coords = false, bool average_coordinates = false, bool to_list = false) {
+Rcpp::List export_From_geojson(std::string input_file, bool flatten_coords = false, bool average_coordinates = false, bool to_list = false, bool geometry_dump = true, bool lazy_coords = false,
+
+                               bool feature_bbox = false, double simplify_tolerance = 0.0, bool profile = false, bool verbose = false, int threads = 1) {
 
   From_GeoJson_geometries prs;
 
+  prs.profiler.set_enabled(profile);
+
+  prs.set_verbose(verbose);
+
+  prs.set_threads(threads);
+
+  prs.set_lazy_coords(lazy_coords);
+
+  prs.set_feature_bbox(feature_bbox);
+
+  prs.set_simplify_tolerance(simplify_tolerance);
+
   json11::Json tmp_prs;
 
   if (prs.file_exists(input_file)) {                                                                                     // check if file exists
@@ -951,9 +1460,115 @@ Rcpp::List export_From_geojson(std::string input_file, bool flatten_coords = fal
     tmp_prs = prs.parse_geojson_string(input_file);                                                                      // input is a geojson character string
   }
 
-  Rcpp::List RES_OUT = prs.helper_geom_objects(prs, tmp_prs, flatten_coords, average_coordinates, false, to_list);                    // schema = false
+  prs.profiler.start("R conversion");
+
+  Rcpp::List RES_OUT = prs.helper_geom_objects(prs, tmp_prs, flatten_coords, average_coordinates, false, to_list, geometry_dump);     // schema = false
 
-  return RES_OUT;
+  return prs.profiler.attach(RES_OUT);
+}
+
+
+
+
+// multiple geojson files [ the files are read and parsed in parallel, whereas the conversion to R objects takes place in the main thread because the R API is single-threaded ]
+//
+
+// [[Rcpp::export]]
+Rcpp::List export_From_geojson_files(std::vector<std::string> input_files, bool flatten_coords = false, bool average_coordinates = false, bool to_list = false,
+
+                                     bool geometry_dump = true, bool lazy_coords = false, bool feature_bbox = false, double simplify_tolerance = 0.0, int threads = 1,
+
+                                     bool profile = false, bool verbose = false) {
+
+  From_GeoJson_geometries prs;
+
+  Phase_Profiler profiler(profile);
+
+  int num_files = input_files.size();
+
+  std::vector<json11::Json> parsed_files(num_files);
+
+  std::vector<std::string> Error_Messages(num_files);
+
+  std::vector<char> read_failed(num_files, 0);
+
+  std::vector<double> file_bytes(num_files, 0.0);
+
+  profiler.start("file read and JSON parse ( parallel )");
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(threads)
+  #endif
+  for (int i = 0; i < num_files; i++) {
+
+    std::string data_in;
+
+    if (!prs.read_geojson_file(input_files[i], data_in)) {
+
+      read_failed[i] = 1;}
+
+    else {
+
+      file_bytes[i] = data_in.size();
+
+      parsed_files[i] = json11::Json::parse(data_in, Error_Messages[i], json11::JsonParse::COMMENTS);
+    }
+  }
+
+  double total_bytes = 0.0;
+
+  for (int i = 0; i < num_files; i++) {
+
+    total_bytes += file_bytes[i];
+
+    profiler.count_json_nodes(parsed_files[i]);
+  }
+
+  profiler.stop(total_bytes);
+
+  for (int i = 0; i < num_files; i++) {                                                                                 // all files are checked before the conversion starts
+
+    if (read_failed[i]) {
+
+      Rcpp::stop("the input file '" + input_files[i] + "' can not be read ( or the gzip-compressed data are invalid )!");
+    }
+
+    if (parsed_files[i].is_null()) {
+
+      Rcpp::stop("The output json object of the file '" + input_files[i] + "' is NULL! See if any of the input data objects is not a valid json data type! " + Error_Messages[i]);
+    }
+  }
+
+  profiler.start("R conversion");
+
+  Rcpp::List RES_OUT(num_files);
+
+  for (int i = 0; i < num_files; i++) {
+
+    Rcpp::checkUserInterrupt();                                                                                          // the parsed objects of the remaining files are released during the unwinding
+
+    if (verbose) Rprintf("file %d of %d: '%s'\n", i + 1, num_files, input_files[i].c_str());                         // followed by the progress of the Features
+
+    From_GeoJson_geometries prs_file;                                                                                    // a separate object for each file [ 'average_coordinates' ]
+
+    prs_file.set_lazy_coords(lazy_coords);
+
+    prs_file.set_feature_bbox(feature_bbox);
+
+    prs_file.set_simplify_tolerance(simplify_tolerance);
+
+    prs_file.set_threads(threads);
+
+    prs_file.set_verbose(verbose);
+
+    RES_OUT[i] = prs_file.helper_geom_objects(prs_file, parsed_files[i], flatten_coords, average_coordinates, false, to_list, geometry_dump);
+
+    parsed_files[i] = json11::Json();                                                                                    // release the parsed object as soon as it is converted
+  }
+
+  RES_OUT.names() = input_files;
+
+  return profiler.attach(RES_OUT);
 }
 
 
@@ -985,17 +1600,17 @@ SEXP export_From_JSON(std::string input_file) {
 
 
 
-// dump a geojson object
+// dump a geojson object [ the large arrays ( for instance the "features" ) are serialized in parallel if 'threads' is greater than 1 ]
 //
 
 // [[Rcpp::export]]
-std::string dump_geojson(std::string input_data) {
+std::string dump_geojson(std::string input_data, int threads = 1) {
 
   From_GeoJson_geometries fgj;
 
   json11::Json tmp_gj = fgj.parse_geojson_objects(input_data);
 
-  return tmp_gj.dump();
+  return tmp_gj.dump(threads);
 }
 
 
@@ -1003,19 +1618,27 @@ std::string dump_geojson(std::string input_data) {
 //
 
 // [[Rcpp::export]]
-std::string Features_TO_Collection(std::vector<std::string> feat_files_lst,
-                                   std::vector<double> bbox_vec,
-                                   bool verbose = false) {
+SEXP Features_TO_Collection(std::vector<std::string> feat_files_lst,
+                            std::vector<double> bbox_vec,
+                            bool verbose = false,
+                            bool profile = false,
+                            int threads = 1) {
 
   From_GeoJson_geometries prs;
 
+  prs.profiler.set_enabled(profile);
+
   json11::Json::array feat_col_array;
 
-  for (unsigned int i = 0; i < feat_files_lst.size(); i++) {
+  int num_files = feat_files_lst.size();
+
+  for (int i = 0; i < num_files; i++) {
+
+    Rcpp::checkUserInterrupt();
 
     std::string input_file = feat_files_lst[i];
 
-    if (verbose) Rcpp::Rcout << "File '" << input_file << "' will be processed ..." << std::endl;
+    if (verbose) Rcpp::Rcout << "File " << i + 1 << " of " << num_files << " ( " << prs.parsed_bytes / 1048576.0 << " MB parsed ) '" << input_file << "' will be processed ..." << std::endl;
 
     json11::Json tmp_prs = prs.parse_geojson_objects(input_file);
 
@@ -1032,7 +1655,197 @@ std::string Features_TO_Collection(std::vector<std::string> feat_files_lst,
 
   };
 
-  return Geom_Coll_OBJ.dump();
+  prs.profiler.start("serialization");
+
+  std::string res = Geom_Coll_OBJ.dump(threads);                                 // the "features" in parallel chunks
+
+  prs.profiler.stop(res.size());
+
+  return prs.profiler.attach(Rcpp::wrap(res));
+}
+
+
+// temporary file next to 'path_to_file' [ it keeps the '.gz' extension, because the compression of the output depends on it ]
+//
+
+inline std::string temporary_path(const std::string &path_to_file) {
+
+  if (is_gzip_path(path_to_file)) return path_to_file.substr(0, path_to_file.size() - 3) + ".tmp.gz";
+
+  return path_to_file + ".tmp";
+}
+
+
+// FeatureCollection from geojson Feature files without parsing them. The top-level structure of each file is validated ( in parallel ) and the raw bytes of
+// the Features are copied to the output. If 'bbox_vec' is empty and 'compute_bbox' is true then the bbox is computed from the "coordinates" of the geometries.
+// If 'path_to_file' is not an empty string then the output is streamed to a temporary file, which is renamed to 'path_to_file' once all Features are valid
+// ( in case of an error or of a user interrupt the temporary file is removed and an existing 'path_to_file' is kept as it is ) and an empty string is returned
+//
+
+// [[Rcpp::export]]
+SEXP splice_Features_TO_Collection(std::vector<std::string> feat_files_lst, std::vector<double> bbox_vec, bool compute_bbox = false,
+
+                                   std::string path_to_file = "", int threads = 1, bool verbose = false, bool profile = false) {
+
+  if (threads < 1) threads = 1;
+
+  Phase_Profiler profiler(profile);
+
+  int num_files = feat_files_lst.size();
+
+  compute_bbox = compute_bbox && bbox_vec.empty();
+
+  double bbox[4] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+
+                     -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+  GeoJson_Writer writer;
+
+  std::string tmp_path = (path_to_file != "") ? temporary_path(path_to_file) : "";
+
+  if (path_to_file != "") {
+
+    if (!writer.open(tmp_path)) Rcpp::stop("the file '" + tmp_path + "' can not be opened for writing!");
+  }
+
+  try {
+
+    writer.put("{\"type\":\"FeatureCollection\",\"features\":[\n");
+
+    int batch_size = threads * 16;                                                          // files per batch ( the Features of a batch are written before the next batch is read )
+
+    for (int b = 0; b < num_files; b += batch_size) {
+
+      Rcpp::checkUserInterrupt();
+
+      int b_end = std::min(b + batch_size, num_files);
+
+      std::vector<Splice_Feature> batch(b_end - b);
+
+      profiler.start("file read and validation ( parallel )");
+
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic) num_threads(threads)
+      #endif
+      for (int i = b; i < b_end; i++) {
+
+        Splice_Feature &feat = batch[i - b];
+
+        if (!read_file_contents(feat_files_lst[i], feat.data)) {
+
+          feat.error = "the file can not be read ( or the gzip-compressed data are invalid )";}
+
+        else {
+
+          Feature_Scanner scanner;
+
+          scanner.validate(feat, compute_bbox);
+        }
+      }
+
+      double batch_bytes = 0.0;
+
+      for (int i = b; i < b_end; i++) batch_bytes += batch[i - b].data.size();
+
+      profiler.stop(batch_bytes);
+
+      profiler.start("write");
+
+      double written_bytes = 0.0;
+
+      for (int i = b; i < b_end; i++) {
+
+        Splice_Feature &feat = batch[i - b];
+
+        if (!feat.error.empty()) Rcpp::stop("the file '" + feat_files_lst[i] + "' is not a valid 'Feature': " + feat.error);
+
+        if (i > 0) writer.put(",\n");
+
+        writer.str().append(feat.data, feat.begin, feat.length);
+
+        written_bytes += feat.length;
+
+        if (compute_bbox) {
+
+          bbox[0] = std::min(bbox[0], feat.bbox[0]);
+
+          bbox[1] = std::min(bbox[1], feat.bbox[1]);
+
+          bbox[2] = std::max(bbox[2], feat.bbox[2]);
+
+          bbox[3] = std::max(bbox[3], feat.bbox[3]);
+        }
+
+        std::string().swap(feat.data);
+
+        writer.maybe_flush();
+      }
+
+      profiler.stop(written_bytes);
+
+      if (verbose) Rprintf("\rnumber of files processed: %d of %d", b_end, num_files);
+    }
+
+    if (verbose) Rprintf("\n");
+
+    writer.put("\n]");
+
+    if (compute_bbox && bbox[0] <= bbox[2]) bbox_vec.assign(bbox, bbox + 4);
+
+    if (!bbox_vec.empty()) {
+
+      writer.put(",\"bbox\":[");
+
+      for (size_t j = 0; j < bbox_vec.size(); j++) {
+
+        if (j > 0) writer.put(',');
+
+        writer.put_double(bbox_vec[j]);
+      }
+
+      writer.put(']');
+    }
+
+    writer.put('}');
+
+    if (path_to_file != "") {
+
+      profiler.start("write");
+
+      writer.close();
+    }
+  }
+
+  catch (...) {                                                                           // invalid Feature, I/O error or user interrupt
+
+    if (path_to_file != "") {
+
+      writer.discard();                                                                   // it does not throw, thus the original exception is kept
+
+      std::remove(tmp_path.c_str());
+    }
+
+    throw;
+  }
+
+  if (path_to_file != "") {                                                               // the temporary file is complete and it is kept if it can not be renamed
+
+    if (std::rename(tmp_path.c_str(), path_to_file.c_str()) != 0) {
+
+      bool target_exists = (errno == EEXIST || errno == EACCES) && std::ifstream(path_to_file).good();
+
+      if (!target_exists || std::remove(path_to_file.c_str()) != 0 || std::rename(tmp_path.c_str(), path_to_file.c_str()) != 0) {    // 'rename()' does not replace an existing file on Windows
+
+        Rcpp::stop("the FeatureCollection was written to the file '" + tmp_path + "', which can not be renamed to '" + path_to_file + "'!");
+      }
+    }
+
+    profiler.stop();
+
+    return profiler.attach(Rcpp::wrap(""));
+  }
+
+  return profiler.attach(Rcpp::wrap(writer.str()));
 }
 
 
@@ -1041,12 +1854,18 @@ std::string Features_TO_Collection(std::vector<std::string> feat_files_lst,
 //
 
 // [[Rcpp::export]]
-Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMETRY_OBJECT_NAME = "", bool average_coordinates = false, bool to_list = false) {
+Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMETRY_OBJECT_NAME = "", bool average_coordinates = false, bool to_list = false, bool geometry_dump = true,
+
+                                      bool lazy_coords = false, bool profile = false) {
 
   Rcpp::List RES_ALL;
 
   From_GeoJson_geometries prs;
 
+  prs.set_lazy_coords(lazy_coords);
+
+  prs.profiler.set_enabled(profile);
+
   json11::Json tmp_prs;
 
   if (prs.file_exists(input_file)) {                                                                 // check if file exists
@@ -1058,6 +1877,8 @@ Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMET
     tmp_prs = prs.parse_geojson_string(input_file);                                                  // input is a geojson character string
   }
 
+  prs.profiler.start("R conversion");
+
   std::string type_col = tmp_prs["type"].string_value();                                             // check initially if the object is a 'Feature' OR a 'Feature-Collection'
 
   if (type_col == "Point" || type_col == "LineString" || type_col == "MultiPoint" ||
@@ -1068,7 +1889,7 @@ Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMET
 
       type_col == "Feature" || type_col == "FeatureCollection") {
 
-    RES_ALL = prs.helper_geom_objects(prs, tmp_prs, false, average_coordinates, true, to_list);}                  // first check that the .geojson object is not one of 'Point', 'Linestring', etc. [ here use 'schema' = true ]
+    RES_ALL = prs.helper_geom_objects(prs, tmp_prs, false, average_coordinates, true, to_list, geometry_dump);}   // first check that the .geojson object is not one of 'Point', 'Linestring', etc. [ here use 'schema' = true ]
 
   else {                                                                                             // otherwise [ if 'GEOMETRY_OBJECT_NAME' != "" ]:
 
@@ -1080,6 +1901,8 @@ Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMET
 
         Rcpp::List RES_OUT;
 
+        prs.reset_COORDS();
+
         std::string res_type = INNER_ITEM["type"].string_value();
 
         int polygon_size = INNER_ITEM["coordinates"].array_items().size();
@@ -1100,163 +1923,246 @@ Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMET
 
           RES_OUT["coordinates"] = prs.geom_OBJ(res_type, INNER_ITEM, polygon_size, average_coordinates, to_list);}
 
-        else {
+        else {
+
+          Rcpp::stop("Give a valid path to a '.geojson' file or a 'GeoJson' character string. Valid GeoJson objects are : 'Point', 'LineString', 'MultiPoint', 'Polygon', 'MultiLineString', 'MultiPolygon', 'GeometryCollection' --> export_From_geojson_schema() function");
+        }
+
+        if (average_coordinates && !to_list) {
+
+          if (geometry_dump) {
+
+            RES_OUT["geometry_dump"] = INNER_ITEM.dump();
+          }
+
+          RES_OUT["leaflet_view_coords"] = prs.return_COORDS();
+        }
+
+        RES_ALL[ITEMS.first] = RES_OUT;
+      }
+
+      else {
+
+        RES_ALL[ITEMS.first] = prs.recursive_switch(ITEMS.second);                           // .... , otherwise [ which means for all other property-names ] do full recursion
+      }
+    }
+  }
+
+  return prs.profiler.attach(RES_ALL);
+}
+
+
+
+//==================================================================================== merge multiple json files to a single file
+
+
+// returns the paths of the (regular) files in a folder ( and in its sub-folders if 'recursive' is true ), which end in one of the 'extensions' ( all files if
+// 'extensions' is empty ). If 'full_path' is false then the paths are relative to the folder [ see the 'directory_walker.h' file ]
+// (much faster than the base R list.files() function with default settings)
+
+// [[Rcpp::export]]
+std::vector<std::string> list_files( const std::string& path, bool full_path = true, bool recursive = false, std::vector<std::string> extensions = std::vector<std::string>(), int threads = 1) {
+
+  std::vector<Dir_Entry> entries = walk_directory(path, recursive, extensions, threads);
+
+  size_t prefix = (path.empty() || path[path.size() - 1] == '/' || path[path.size() - 1] == '\\') ? path.size() : path.size() + 1;
+
+  std::vector <std::string> result(entries.size());
+
+  for (size_t i = 0; i < entries.size(); i++) {
+
+    result[i] = full_path ? entries[i].path : entries[i].path.substr(prefix);
+  }
+
+  return result;
+}
+
+
+// paths and sizes ( in bytes ) of the files of a folder, so that the work can be balanced by the size of the files [ see the 'list_files()' function ]
+//
 
-          Rcpp::stop("Give a valid path to a '.geojson' file or a 'GeoJson' character string. Valid GeoJson objects are : 'Point', 'LineString', 'MultiPoint', 'Polygon', 'MultiLineString', 'MultiPolygon', 'GeometryCollection' --> export_From_geojson_schema() function");
-        }
+// [[Rcpp::export]]
+Rcpp::List list_files_sizes(const std::string& path, bool recursive = true, std::vector<std::string> extensions = std::vector<std::string>(), int threads = 1) {
 
-        if (average_coordinates && !to_list) {
+  std::vector<Dir_Entry> entries = walk_directory(path, recursive, extensions, threads);
 
-          RES_OUT["geometry_dump"] = INNER_ITEM.dump();
+  Rcpp::CharacterVector paths(entries.size());
 
-          RES_OUT["leaflet_view_coords"] = prs.return_COORDS();
-        }
+  Rcpp::NumericVector sizes(entries.size());
 
-        RES_ALL[ITEMS.first] = RES_OUT;
-      }
+  for (size_t i = 0; i < entries.size(); i++) {
 
-      else {
+    paths[i] = entries[i].path;
 
-        RES_ALL[ITEMS.first] = prs.recursive_switch(ITEMS.second);                           // .... , otherwise [ which means for all other property-names ] do full recursion
-      }
-    }
+    sizes[i] = entries[i].size;
   }
 
-  return RES_ALL;
+  return Rcpp::List::create(Rcpp::Named("path") = paths, Rcpp::Named("size") = sizes);
 }
 
 
 
-//==================================================================================== merge multiple json files to a single file
-
-
-// returns the paths of files in a folder
-// http://www.cplusplus.com/forum/unices/3548/
-// (much faster than the base R list.files() function with default settings)
+// a batch of consecutive files, which are concatenated ( including the delimiters ) to a single block of data [ it does not use the R API, thus it can be
+// read in a separate thread while the previous batch is written ]
+//
 
-// [[Rcpp::export]]
-std::vector<std::string> list_files( const std::string& path, bool full_path = true) {
+struct Merge_Batch {
 
-  std::vector <std::string> result;
+  std::string data;
 
-  dirent* de;
+  unsigned int next_file;                                     // index of the first file of the next batch
 
-  DIR* dp;
+  int invalid_file;                                           // index of the file that could not be read ( -1 if all files were read )
 
-  errno = 0;
+  double read_seconds;                                        // wall time of the read of the batch [ 'profile' = TRUE ]
 
-  dp = opendir( path.empty() ? "." : path.c_str() );
+  Merge_Batch() : next_file(0), invalid_file(-1), read_seconds(0.0) { }
+};
 
-  if (dp) {
 
-    while (true) {
+// reads files starting from 'start_file' until the batch exceeds 'batch_bytes' ( the delimiter precedes every file except for the first one )
+//
 
-      errno = 0;
+Merge_Batch read_merge_batch(const std::vector<std::string> &all_files, unsigned int start_file, const std::string &concat_delimiter, size_t batch_bytes) {
 
-      de = readdir( dp );
+  Merge_Batch batch;
 
-      if (de == NULL) break;
+  arma::wall_clock timer;
 
-      std::string tmp = std::string( de->d_name );
+  timer.tic();
 
-      int count = std::count_if(tmp.begin(), tmp.end(),[](char c){ return (std::isalnum(c)); });
+  batch.data.reserve(batch_bytes + (batch_bytes >> 2));
 
-      if (count > 0) {
+  std::string data_in;
 
-        if (full_path) {
+  unsigned int i = start_file;
 
-          std::string full_str = path + tmp;
+  for (; i < all_files.size() && batch.data.size() < batch_bytes; i++) {
 
-          result.push_back( full_str );}
+    if (!read_file_contents(all_files[i], data_in)) {                          // the gzip-compressed input files are inflated
 
-        else {
+      batch.invalid_file = i;
 
-          result.push_back( tmp );
-        }
-      }
+      break;
     }
 
-    closedir( dp );
+    if (i > 0) batch.data.append(concat_delimiter);
 
-    std::sort( result.begin(), result.end() );
+    batch.data.append(data_in);
   }
 
-  return result;
-}
+  batch.next_file = i;
 
+  batch.read_seconds = timer.toc();
+
+  return batch;
+}
 
 
 // read 'json-files' (or any kind of .txt file) from a directory and append it to an 'output-file'
 // [ use concat to specify the position of each appended file ( newline, empty space etc. ) ]
 //
+// the files are concatenated in batches of (approximately) 8 MB, which are written with a single call. The next batch is read in a separate thread
+// ( std::async ) while the current batch is written, so that the reads of the (many small) files overlap with the writes. If 'profile' is true then the
+// per-phase timing is returned ( the read of the batches overlaps with the write, therefore the sum of the phases exceeds the total time )
+//
 
 // [[Rcpp::export]]
-void merge_json(const std::string& input_folder, std::string output_file, std::string concat_delimiter = "\n", bool verbose = false) {
+SEXP merge_json(const std::string& input_folder, std::string output_file, std::string concat_delimiter = "\n", bool verbose = false, bool recursive = false,
+
+                std::vector<std::string> extensions = std::vector<std::string>(), int threads = 1, bool profile = false) {
 
   arma::wall_clock timer;
 
+  Phase_Profiler profiler(profile);
+
+  profiler.start("list files");
+
   if (verbose) {
 
     timer.tic(); Rprintf("\n");
   }
 
-  std::vector<std::string> all_files = list_files(input_folder, true);        // by default return full-paths
+  std::vector<std::string> all_files = list_files(input_folder, true, recursive, extensions, threads);        // by default return full-paths
+
+  profiler.stop();
 
   if (all_files.empty()) {
 
     Rcpp::stop("the folder is empty");
   }
 
-  std::ofstream out;
+  GeoJson_Writer out;                                                         // gzip-compressed output if the 'output_file' ends in '.gz'
+
+  if (!out.open(output_file, true)) {
 
-  out.open(output_file, std::ios::app);
+    Rcpp::stop("the file '" + output_file + "' can not be opened for writing!");
+  }
 
-  for (unsigned int i = 0; i < all_files.size(); i++) {
+  const size_t batch_bytes = 1 << 23;
 
-    std::string data_in;
+  double total_bytes = 0.0;
 
-    std::fstream myfile(all_files[i], std::fstream::in);
+  std::future<Merge_Batch> next_batch = std::async(std::launch::async, read_merge_batch, std::cref(all_files), 0u, std::cref(concat_delimiter), batch_bytes);
 
-    char chs;
+  while (true) {
 
-    while (myfile >> std::noskipws >> chs) {
+    profiler.start("wait for file read");
 
-      data_in += chs;
-    }
+    Merge_Batch batch = next_batch.get();
 
-    if (i == 0) {
+    profiler.stop();
 
-      out << data_in;}
+    profiler.add("file read ( prefetch thread )", batch.read_seconds, batch.data.size());
 
-    else {
+    bool last_batch = batch.invalid_file >= 0 || batch.next_file >= all_files.size();
 
-      out << concat_delimiter + data_in;
+    if (!last_batch) {                                                        // prefetch the next batch before the current one is written
+
+      next_batch = std::async(std::launch::async, read_merge_batch, std::cref(all_files), batch.next_file, std::cref(concat_delimiter), batch_bytes);
     }
 
-    if (verbose) {
+    profiler.start("write");
+
+    out.write_direct(batch.data);
+
+    profiler.stop(batch.data.size());
 
-      std::string tns = std::to_string(all_files.size());
+    total_bytes += batch.data.size();
 
-      const char* in_rpr = "\rnumber of files processed: %2d of ";
+    if (batch.invalid_file >= 0) {
 
-      char const* pchar = tns.c_str();
+      Rcpp::stop("the file '" + all_files[batch.invalid_file] + "' can not be read ( or the gzip-compressed data are invalid )!");
+    }
+
+    if (verbose) {
 
-      char * RutaFinal = new char[strlen(in_rpr) + strlen(pchar) + 1];    // concatenation of const char* : https://stackoverflow.com/questions/8487337/how-to-concat-two-const-char
-      strcpy(RutaFinal, in_rpr);
-      strcat(RutaFinal, pchar);
+      double secs = timer.toc();
 
-      Rprintf(RutaFinal, i + 1);
+      Rprintf("\rnumber of files processed: %d of %d ( %.2f MB/s )", batch.next_file, static_cast<int>(all_files.size()), (secs > 0.0) ? total_bytes / (1024.0 * 1024.0 * secs) : 0.0);
     }
+
+    if (last_batch) break;
+
+    Rcpp::checkUserInterrupt();                                               // once per batch [ during the unwinding the destructor of the 'next_batch' waits for the pending read ]
   }
 
+  profiler.start("write");
+
+  out.close();
+
+  profiler.stop();
+
   if (verbose) {
 
     double n = timer.toc();
 
-    Rprintf("\ttotal.time.in.minutes: %.5f", n / 60.0);
+    Rprintf("\ttotal.time.in.minutes: %.5f\ttotal.MB: %.2f\n", n / 60.0, total_bytes / (1024.0 * 1024.0));
   }
 
-  out.close();
+  if (profile) return profiler.summary();
+
+  return R_NilValue;
 }
 
 
@@ -1323,114 +2229,264 @@ std::string DATA_TYPE(SEXP sublist) {
 
 
 
-// inner function for 'SAVE_R_list_Features_2_FeatureCollection'
-// which concatenates the coordinates
+// Structures for 'SAVE_R_list_Features_2_FeatureCollection'
+//
+// the data of the Features are extracted from the R lists in the main thread ( the coordinates are not copied, a ring points to the memory of the
+// R matrix which is only read afterwards ) and then the Features are serialized in parallel without calling the R API
 //
 
-// [[Rcpp::export]]
-std::string inner_coords(Rcpp::List geom_lst, int z, bool polygon_interior = false) {
+struct Ring_Data {
 
-  Rcpp::NumericMatrix geom_mt = Rcpp::as<Rcpp::NumericMatrix>(geom_lst[z]);             // this matrix will have 2 columns (longitude and latitude)
-  std::string geom_str_poly;
+  const double *coords;                               // column-major matrix of 2 columns ( longitude and latitude )
 
-  for (int w = 0; w < geom_mt.nrow(); w++) {
+  int num_rows;
+};
 
-    Rcpp::NumericVector tmp_inner = geom_mt.row(w);
 
-    if (tmp_inner.size() != 2) {
-      Rcpp::stop("The input data MUST have 2 columns ('latitude' and 'longitude')!");
-    }
+struct Property_Data {
 
-    double first_item = tmp_inner[0];
-    double second_item = tmp_inner[1];
+  std::string name;
 
-    if (w == 0) {
-      if (polygon_interior) {
-        geom_str_poly += "[";
-      }
-      else {
-        geom_str_poly += "[[";
-      }
-    }
+  std::string kind;                                   // 'string', 'double' or 'int' [ see the 'DATA_TYPE' function ]
 
-    geom_str_poly += "[" + std::to_string(first_item) + "," + std::to_string(second_item) + "]";
+  std::string str_value;
 
-    if (w < geom_mt.nrow() - 1) {
-      geom_str_poly += ",";
-    }
-    if (w == geom_mt.nrow() - 1) {
-      if (polygon_interior) {
-        geom_str_poly += "]";
-      }
-      else {
-        geom_str_poly += "]]";
-      }
-    }
+  double dbl_value;
+
+  int int_value;
+};
+
+
+struct Feature_Data {
+
+  std::string id;                                     // serialized 'id' member
+
+  std::vector<Property_Data> properties;
+
+  std::string geometry_type;                          // serialized 'type' member of the geometry
+
+  bool multi_polygon;                                 // the coordinates are an array of polygons
+
+  std::vector<std::vector<Ring_Data> > polygons;      // the ring(s) of each polygon
+
+  Feature_Data() : multi_polygon(false) { }
+};
+
+
+
+// adds a ring-matrix ( 2 columns ) to the rings of a polygon [ an integer matrix is converted and kept in 'keep_alive' so that the memory remains valid ]
+//
+
+void extract_ring(SEXP geom_mt, std::vector<Ring_Data> &rings, std::vector<Rcpp::NumericMatrix> &keep_alive) {
+
+  if (!Rf_isMatrix(geom_mt) || (TYPEOF(geom_mt) != REALSXP && TYPEOF(geom_mt) != INTSXP)) {
+
+    Rcpp::stop("Invalid Geometry object! The rings of the polygons must be numeric matrices!");
   }
 
-  return geom_str_poly;
-}
+  Rcpp::NumericMatrix tmp_mt(geom_mt);                                             // this matrix will have 2 columns (longitude and latitude)
+
+  if (tmp_mt.ncol() != 2) {
 
+    Rcpp::stop("The input data MUST have 2 columns ('latitude' and 'longitude')!");
+  }
+
+  if (TYPEOF(geom_mt) != REALSXP) keep_alive.push_back(tmp_mt);
+
+  Ring_Data ring;
+
+  ring.coords = tmp_mt.begin();
 
+  ring.num_rows = tmp_mt.nrow();
+
+  rings.push_back(ring);
+}
 
 
-// inner function for 'SAVE_R_list_Features_2_FeatureCollection' which
-// deals with Polygons with interior rings
+
+// adds a polygon [ a numeric matrix ( Polygon without interior rings ) OR a list of numeric matrices ( Polygon with interior rings ) ]
 //
 
-// [[Rcpp::export]]
-std::string Polygon_with_interior_rings(Rcpp::List geom_lst, int i, bool verbose) {
+void extract_polygon(SEXP geom_obj, int i, bool verbose, std::vector<std::vector<Ring_Data> > &polygons, std::vector<Rcpp::NumericMatrix> &keep_alive) {
 
-  if (verbose) Rcpp::Rcout << "Input Feature: " << i+1 << "  --  POLYGON with INTERIOR Rings!" << std::endl;
-  Rcpp::List Poly_interior = geom_lst[0];
-  std::vector<std::string> all_interiors;
-  std::string coords;
+  std::vector<Ring_Data> rings;
 
-  for (unsigned int m = 0; m < Poly_interior.size(); m++) {
+  if (TYPEOF(geom_obj) == VECSXP) {
 
-    std::string geom_str_poly = inner_coords(Poly_interior, m, true);
-    all_interiors.push_back(geom_str_poly);
+    if (verbose) Rcpp::Rcout << "Input Feature: " << i+1 << "  --  POLYGON with INTERIOR Rings!" << std::endl;
 
-    if (m != (Poly_interior.size() - 1)) {
-      all_interiors.push_back(", ");
+    for (R_xlen_t m = 0; m < Rf_xlength(geom_obj); m++) {
+
+      extract_ring(VECTOR_ELT(geom_obj, m), rings, keep_alive);
     }
   }
 
-  coords += "[";
+  else {
 
-  for (unsigned int n = 0; n < all_interiors.size(); n++) {
-    coords += all_interiors[n];
+    extract_ring(geom_obj, rings, keep_alive);
   }
 
-  coords += "]";
+  polygons.push_back(rings);
+}
+
+
+
+// serializes a ring ( only the positions of 'keep' if the rings of the polygon were simplified )
+//
+
+void serialize_ring(GeoJson_Writer &writer, const Ring_Data &ring, const std::vector<int> *keep) {
+
+  const double *x = ring.coords, *y = ring.coords + ring.num_rows;
+
+  int num_rows = (keep != NULL) ? keep->size() : ring.num_rows;
+
+  writer.put('[');
+
+  for (int k = 0; k < num_rows; k++) {
+
+    int w = (keep != NULL) ? (*keep)[k] : k;
+
+    if (k > 0) writer.put(',');
+
+    writer.put('[');
+
+    writer.put_double(x[w]);
 
-  return coords;
+    writer.put(',');
+
+    writer.put_double(y[w]);
+
+    writer.put(']');
+  }
+
+  writer.put(']');
 }
 
 
 
+// serializes a Feature. The members are written in the order : "geometry", "id", "properties", "type"
+//
+
+void serialize_feature(GeoJson_Writer &writer, const Feature_Data &feat, double simplify_tolerance) {
+
+  writer.put("{\"geometry\":{");
+
+  writer.put(feat.geometry_type);
+
+  writer.put(", \"coordinates\":");
+
+  if (feat.multi_polygon || feat.polygons.empty()) writer.put('[');
+
+  for (size_t p = 0; p < feat.polygons.size(); p++) {
+
+    if (p > 0) writer.put(',');
+
+    writer.put('[');
+
+    const std::vector<Ring_Data> &rings = feat.polygons[p];
+
+    std::vector<std::vector<int> > rings_keep;
+
+    if (simplify_tolerance > 0.0) {                                                    // the rings of a polygon are simplified together [ see 'simplify_polygon()' ]
+
+      std::vector<const double *> x(rings.size()), y(rings.size());
+
+      std::vector<int> n(rings.size());
+
+      for (size_t r = 0; r < rings.size(); r++) {
+
+        x[r] = rings[r].coords;
+
+        y[r] = rings[r].coords + rings[r].num_rows;
+
+        n[r] = rings[r].num_rows;
+      }
+
+      rings_keep = simplify_polygon(x, y, n, simplify_tolerance);
+    }
+
+    for (size_t r = 0; r < rings.size(); r++) {
+
+      if (r > 0) writer.put(", ");
+
+      serialize_ring(writer, rings[r], rings_keep.empty() ? NULL : &rings_keep[r]);
+    }
+
+    writer.put(']');
+  }
+
+  if (feat.multi_polygon || feat.polygons.empty()) writer.put(']');
+
+  writer.put("}, ");
+
+  writer.put(feat.id);
+
+  writer.put(", \"properties\":{");
+
+  for (size_t k = 0; k < feat.properties.size(); k++) {
+
+    const Property_Data &prop = feat.properties[k];
+
+    if (k > 0) writer.put(", ");
+
+    writer.put_string(prop.name);
+
+    writer.put(':');
+
+    if (prop.kind == "string") {
+
+      writer.put_string(prop.str_value);}
+
+    else if (prop.kind == "double") {
+
+      writer.put_double(prop.dbl_value);}
+
+    else {
+
+      writer.put(std::to_string(prop.int_value));
+    }
+  }
+
+  writer.put("}, \"type\":\"Feature\"}");
+}
+
+
 
 // This function takes GeoJson Features in form of R lists and write those Features to a 'FeatureCollection'
+// The Features are serialized in parallel ( chunks of Features are written to separate buffers, which are then concatenated in order ). If 'path_to_file'
+// is not an empty string then the output is saved to the file and returned, except if 'stream' is true, where the output is streamed to the file ( in
+// batches of chunks, so that it is not kept in memory ) and an empty string is returned
 //
 
 // [[Rcpp::export]]
-std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string path_to_file = "", bool verbose = false) {
+SEXP SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string path_to_file = "", bool verbose = false, double simplify_tolerance = 0.0,
+
+                                              int precision = -1, int threads = 1, bool profile = false, bool stream = false) {
+
+  Phase_Profiler profiler(profile);
+
+  profiler.start("R extraction");
 
   std::vector<std::string> allowed_attributes = {"type", "id", "properties", "geometry"};
   std::sort(allowed_attributes.begin(), allowed_attributes.end());                                // sort both the 'allowed_attributes' and 'input_attrubutes' so that 'std::equal' can function properly
-  std::map<int, std::map<std::string, std::string> > OUTER_map;
 
-  for (unsigned int i = 0; i < x.size(); i++) {                                                   // 'x' is a list of 'Features'
+  int num_feat = x.size();
+  std::vector<Feature_Data> features(num_feat);
+  std::vector<Rcpp::NumericMatrix> keep_alive;
+
+  for (int i = 0; i < num_feat; i++) {                                                            // 'x' is a list of 'Features'
+
+    if ((i + 1) % interrupt_interval == 0) Rcpp::checkUserInterrupt();                           // the extracted Features are released during the unwinding
 
     Rcpp::List sublist = x[i];
 
     Rcpp::CharacterVector nams_sublist = sublist.names();
     std::vector<std::string> input_attrubutes = Rcpp::as<std::vector<std::string> >(nams_sublist);
     std::sort(input_attrubutes.begin(), input_attrubutes.end());
-    bool result = std::equal(input_attrubutes.begin(), input_attrubutes.end(), allowed_attributes.begin());
+    bool result = input_attrubutes.size() == allowed_attributes.size() && std::equal(input_attrubutes.begin(), input_attrubutes.end(), allowed_attributes.begin());
     if (!result) Rcpp::stop("The input lists / sublists must include the following names: 'type', 'id', 'properties' and 'geometry'!");
 
-    std::map<std::string, std::string> INNER_map;
+    Feature_Data &feat = features[i];
 
     for (unsigned int j = 0; j < nams_sublist.size(); j++) {
 
@@ -1447,9 +2503,6 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
           if (inner_data != "Feature") {
             Rcpp::stop("In case that the name of the input object equals to 'type' then it MUST be a 'Feature' attribute! Sublist:" + std::to_string(i+1) + " type:" + std::to_string(j+1));
           }
-          else {
-            INNER_map["type"] = "\"type\":\"Feature\"";                                           // add quotes to an std::string [ https://stackoverflow.com/a/12338826/8302386 ]
-          }
         }
         else {
           Rcpp::stop("In case that the name of the input object equals to 'type' then it MUST be a character string! Sublist:" + std::to_string(i+1) + " type:" + std::to_string(j+1));
@@ -1462,13 +2515,15 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
         if (DATA_TYPE(sexp_obj) == "string") {
           std::string inner_data = sublist[inner_name];
           ID = inner_data;
-          INNER_map["id"] = "\"id\":\"" + inner_data + "\"";
+          GeoJson_Writer tmp_id;
+          tmp_id.put_string(inner_data);
+          feat.id = "\"id\":" + tmp_id.str();
         }
         else if (DATA_TYPE(sexp_obj) == "int") {
           int inner_data = sublist[inner_name];
           std::string conv_to_str = std::to_string(inner_data);
           ID = conv_to_str;
-          INNER_map["id"] = "\"id\":" + conv_to_str;
+          feat.id = "\"id\":" + conv_to_str;
         }
         else {
           Rcpp::stop("In case that the name of the input object equals to 'id' then it MUST be either a character string OR an integer! Sublist:" + std::to_string(i+1) + " id:" + std::to_string(j+1));
@@ -1480,50 +2535,31 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
         if (DATA_TYPE(sexp_obj) == "list") {
 
           Rcpp::List inner_props = sublist[inner_name];
-          Rcpp::CharacterVector nams_props = inner_props.names();
-          std::vector<std::string> props_vec;
+          std::vector<std::string> nams_props;
+          if (inner_props.size() > 0) nams_props = Rcpp::as<std::vector<std::string> >(inner_props.names());
 
           for (unsigned int k = 0; k < nams_props.size(); k++) {
 
-            std::string inner_name_props = Rcpp::as<std::string>(nams_props[k]);
-            SEXP sexp_prop = inner_props[inner_name_props];
-            std::string tmp_prop;
+            SEXP sexp_prop = inner_props[k];
+            Property_Data prop;
+            prop.name = nams_props[k];
+            prop.kind = DATA_TYPE(sexp_prop);
 
-            if (DATA_TYPE(sexp_prop) == "string") {
-              std::string inner_prop_str = inner_props[inner_name_props];
-              tmp_prop = "\"" + inner_name_props + "\"" + ":" + "\"" + inner_prop_str + "\"";
+            if (prop.kind == "string") {
+              prop.str_value = Rcpp::as<std::string>(sexp_prop);
             }
-            else if (DATA_TYPE(sexp_prop) == "double") {
-              double tmp_double = inner_props[inner_name_props];
-              tmp_prop = "\"" + inner_name_props + "\"" + ":" + std::to_string(tmp_double);
+            else if (prop.kind == "double") {
+              prop.dbl_value = Rcpp::as<double>(sexp_prop);
             }
-            else if (DATA_TYPE(sexp_prop) == "int") {
-              int tmp_int = inner_props[inner_name_props];
-              tmp_prop = "\"" + inner_name_props + "\"" + ":" + std::to_string(tmp_int);
+            else if (prop.kind == "int") {
+              prop.int_value = Rcpp::as<int>(sexp_prop);
             }
             else {
               Rcpp::stop("In case that the name of the input object equals to 'properties' then each item in 'properties' MUST be of type: 'string', 'double' or 'int'! Sublist:" + std::to_string(i+1) + " properties:" + std::to_string(j+1) + " properties-item:" + std::to_string(k+1));
             }
 
-            if (k != nams_props.size() - 1) {                                // add trailing comma except for the last item
-              tmp_prop += ", ";
-            }
-            props_vec.push_back(tmp_prop);
-          }
-
-          std::string props_out;
-          for (unsigned int t = 0; t < props_vec.size(); t++) {
-            if (t == 0) {
-              props_out += "{";                                              // add an opening curly brace at the beginning
-            }
-
-            props_out += props_vec[t];                                       // in any case add the item to the string
-
-            if (t == props_vec.size() - 1) {
-              props_out += "}";                                              // add a closing curly brace at the end
-            }
+            feat.properties.push_back(prop);
           }
-          INNER_map["properties"] = "\"properties\":" + props_out;
         }
         else {
           Rcpp::stop("In case that the name of the input object equals to 'properties' then it MUST be a list object! Sublist:" + std::to_string(i+1) + " properties:" + std::to_string(j+1));
@@ -1531,9 +2567,6 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
       }
       else if (inner_name == "geometry") {
 
-        std::string type_geom;
-        std::string coords;
-
         if (DATA_TYPE(sexp_obj) == "list") {
           Rcpp::List inner_geom = sublist[inner_name];
           Rcpp::CharacterVector nams_geom = inner_geom.names();
@@ -1544,20 +2577,12 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
             SEXP sexp_geom = inner_geom[inner_name_geom];
 
             if (nams_geom[s] == "type") {
-              std::string tmp_geom_type = inner_geom[inner_name_geom];
 
               if (DATA_TYPE(sexp_geom) == "string") {                       // account for all cases: 'Polygon', 'POLYGON', 'MultiPolygon', 'MULTIPOLYGON'
-                if (tmp_geom_type == "Polygon") {
-                  type_geom = "\"type\":\"Polygon\"";
-                }
-                else if (tmp_geom_type == "POLYGON") {
-                  type_geom = "\"type\":\"POLYGON\"";
-                }
-                else if (tmp_geom_type == "MultiPolygon") {
-                  type_geom = "\"type\":\"MultiPolygon\"";
-                }
-                else if (tmp_geom_type == "MULTIPOLYGON") {
-                  type_geom = "\"type\":\"MULTIPOLYGON\"";
+                std::string tmp_geom_type = inner_geom[inner_name_geom];
+
+                if (tmp_geom_type == "Polygon" || tmp_geom_type == "POLYGON" || tmp_geom_type == "MultiPolygon" || tmp_geom_type == "MULTIPOLYGON") {
+                  feat.geometry_type = "\"type\":\"" + tmp_geom_type + "\"";
                 }
                 else {
                   Rcpp::stop("In case that the name of the input object equals to 'geometry' then the 'type' MUST be either a 'Polygon' or a 'MultiPolygon'! Sublist:" + std::to_string(i+1) + " geometry:" + std::to_string(j+1));
@@ -1575,42 +2600,24 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
 
                 if (geom_lst.size() == 1) {                                                                      // 1st. case: If the list is of length 1, I expect that the Geometry is a Polygon with Interior rings (such as Countries with enclaves, see South Africa & Lesotho or Italy & (Vatican, San Marino)). This list will include 2 or more numeric matrices.
 
-                  coords = Polygon_with_interior_rings(geom_lst, i, verbose);
+                  feat.multi_polygon = false;
+                  extract_polygon(geom_lst[0], i, verbose, feat.polygons, keep_alive);
                 }
                 else {                                                                                           // 2nd. case: Here I expect that the Geometry is a Multipolygon (a list of length > 1, where each sublist is a numeric matrix)
 
                   if (verbose) Rcpp::Rcout << "Input Feature: " << i+1 << "  --  MULTIPOLYGON!!" << std::endl;
 
-                  for (unsigned int z = 0; z < geom_lst.size(); z++) {
-
-                    SEXP sexp_inner_geom = geom_lst[z];
-
-                    std::string geom_str_poly;
+                  feat.multi_polygon = true;
 
-                    if (DATA_TYPE(sexp_inner_geom) == "list") {
+                  for (unsigned int z = 0; z < geom_lst.size(); z++) {
 
-                      geom_str_poly = Polygon_with_interior_rings(geom_lst, i, verbose);
-                    }
-                    else if (DATA_TYPE(sexp_inner_geom) == "NUMERIC_matrix_array_vector") {
+                    SEXP sexp_inner_geom = geom_lst[z];                                                          // each polygon is processed [ previously the first polygon was repeated for every polygon with interior rings ]
 
-                      geom_str_poly = inner_coords(geom_lst, z, false);
-                    }
-                    else {
+                    if (DATA_TYPE(sexp_inner_geom) != "list" && DATA_TYPE(sexp_inner_geom) != "NUMERIC_matrix_array_vector") {
                       Rcpp::stop("Invalid Geometry object in case of MULTIPOLYGON! It must be either of type 'list' or 'numeric matrix'!");
                     }
 
-                    if (z == 0) {
-                      coords += "[";
-                    }
-                    if (z != geom_lst.size() - 1) {
-                      coords += geom_str_poly + ",";
-                    }
-                    else {
-                      coords += geom_str_poly;
-                    }
-                    if (z == geom_lst.size() - 1) {
-                      coords += "]";
-                    }
+                    extract_polygon(sexp_inner_geom, i, verbose, feat.polygons, keep_alive);
                   }
                 }
               }
@@ -1618,33 +2625,8 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
 
                 if (verbose) Rcpp::Rcout << "Input Feature: " << i+1 << "  --  POLYGON WITHOUT INTERIOR Rings!" << std::endl;
 
-                Rcpp::NumericMatrix geom_mt_single = Rcpp::as<Rcpp::NumericMatrix>(inner_geom[inner_name_geom]);             // this matrix will have 2 columns (longitude and latitude)
-                std::string geom_str_poly_single;
-
-                for (int w1 = 0; w1 < geom_mt_single.nrow(); w1++) {
-
-                  Rcpp::NumericVector tmp_inner = geom_mt_single.row(w1);
-
-                  if (tmp_inner.size() != 2) {
-                    Rcpp::stop("The input data MUST have 2 columns ('latitude' and 'longitude')!");
-                  }
-
-                  double first_item1 = tmp_inner[0];
-                  double second_item1 = tmp_inner[1];
-
-                  if (w1 == 0) {
-                    coords += "[[";
-                  }
-
-                  coords += "[" + std::to_string(first_item1) + "," + std::to_string(second_item1) + "]";
-
-                  if (w1 < geom_mt_single.nrow() - 1) {
-                    coords += ",";
-                  }
-                  if (w1 == geom_mt_single.nrow() - 1) {
-                    coords += "]]";
-                  }
-                }
+                feat.multi_polygon = false;
+                extract_polygon(sexp_geom, i, false, feat.polygons, keep_alive);
               }
               else {
                 Rcpp::stop("In case that the name of the input object equals to 'geometry' then the 'coordinates' attribute MUST be either a list OR a NUMERIC matrix (of type double because the coordinates are normally latitudes and longitudes)! Sublist:" + std::to_string(i+1) + " geometry:" + std::to_string(j+1));
@@ -1658,55 +2640,149 @@ std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string p
         else {
           Rcpp::stop("In case that the name of the input object equals to 'geometry' then it MUST be a list object! Sublist:" + std::to_string(i+1) + " geometry:" + std::to_string(j+1));
         }
-
-        INNER_map["geometry"] = "\"geometry\":{" + type_geom + ", \"coordinates\":" + coords + "}";
       }
     }
+  }
+
+  profiler.stop();
 
-    OUTER_map[i] = INNER_map;
+  if (threads < 1) threads = 1;
+
+  GeoJson_Writer writer(precision);
+  GeoJson_Writer file_writer(precision);                                                           // the output file if the output is not streamed
+
+  if (path_to_file != "") {
+
+    GeoJson_Writer &target = stream ? writer : file_writer;
+
+    if (!target.open(path_to_file)) Rcpp::stop("the file '" + path_to_file + "' can not be opened for writing!");
   }
 
-  std::string feature_collection_str = "{\"type\":\"FeatureCollection\",\"features\":[\n";
+  writer.put("{\"type\":\"FeatureCollection\",\"features\":[\n");
 
-  for(unsigned int iter = 0; iter < OUTER_map.size(); iter++) {
+  int chunk_size = 64;                                                                             // features per buffer
+  int batch_size = chunk_size * threads * 8;                                                       // features per batch ( the buffers of a batch are concatenated before the next batch )
+  double total_bytes = 0.0;
 
-    std::map<std::string, std::string> this_map = OUTER_map[iter];
+  for (int b = 0; b < num_feat; b += batch_size) {
 
-    std::string this_inner_map = "{";
+    Rcpp::checkUserInterrupt();                                                                    // between the batches ( outside of the parallel region ), the output file is closed by the destructor of the 'writer'
 
-    unsigned int count = 0;
+    int b_end = std::min(b + batch_size, num_feat);
+    int num_chunks = (b_end - b + chunk_size - 1) / chunk_size;
+    std::vector<std::string> chunks(num_chunks);
 
-    for(auto iter_in : this_map) {
+    profiler.start("serialization ( parallel )");
 
-      if (count < this_map.size() - 1) {
-        this_inner_map += iter_in.second + ", ";
-      }
-      else {
-        this_inner_map += iter_in.second;
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    #endif
+    for (int c = 0; c < num_chunks; c++) {
+
+      GeoJson_Writer chunk_writer(precision);
+      int c_start = b + c * chunk_size;
+      int c_end = std::min(c_start + chunk_size, b_end);
+
+      for (int i = c_start; i < c_end; i++) {
+
+        serialize_feature(chunk_writer, features[i], simplify_tolerance);
+
+        if (i != num_feat - 1) chunk_writer.put(",\n");
       }
-      count += 1;
+
+      chunks[c].swap(chunk_writer.str());
     }
 
-    this_inner_map += "}";
+    double batch_bytes = 0.0;
+    for (int c = 0; c < num_chunks; c++) batch_bytes += chunks[c].size();
 
-    if (iter != OUTER_map.size() - 1) {
-      this_inner_map += ",\n";
+    profiler.stop(batch_bytes);
+    profiler.start("write");
+
+    for (int c = 0; c < num_chunks; c++) {
+
+      writer.put(chunks[c]);
+      std::string().swap(chunks[c]);
+      writer.maybe_flush();
     }
 
-    feature_collection_str += this_inner_map;
+    profiler.stop(batch_bytes);
+
+    total_bytes += batch_bytes;
+
+    if (verbose) Rprintf("\rserialized Features: %d of %d ( %.1f MB )", b_end, num_feat, total_bytes / 1048576.0);
   }
 
-  feature_collection_str += "]}";
+  if (verbose) Rprintf("\n");
 
+  writer.put("]}");
 
   if (path_to_file != "") {
 
-    std::ofstream out(path_to_file);
-    out << feature_collection_str;
-    out.close();
+    profiler.start("write");
+
+    if (stream) {
+
+      writer.close();
+      profiler.stop();
+      return profiler.attach(Rcpp::wrap(""));
+    }
+
+    file_writer.write_direct(writer.str());
+    file_writer.close();
+    profiler.stop(writer.str().size());
   }
 
-  return feature_collection_str;
+  return profiler.attach(Rcpp::wrap(writer.str()));
 }
 
 
+
+//==================================================================================== allocation statistics
+
+
+// enables ( or disables ) the allocation counters of the json11 nodes and of the Rcpp::List reallocations and returns the current counts. If 'reset' is true
+// then the counters are set to zero after they are returned
+//
+
+// [[Rcpp::export]]
+Rcpp::List export_alloc_stats(int enable = -1, bool reset = false) {
+
+  if (enable >= 0) json11::set_alloc_tracking(enable > 0);
+
+  unsigned long long counts[json11::ALLOC_NODE_TYPES], bytes[json11::ALLOC_NODE_TYPES];
+
+  json11::alloc_stats(counts, bytes);
+
+  Rcpp::NumericVector node_counts(json11::ALLOC_NODE_TYPES), node_bytes(json11::ALLOC_NODE_TYPES);
+
+  for (int i = 0; i < json11::ALLOC_NODE_TYPES; i++) {
+
+    node_counts[i] = static_cast<double>(counts[i]);
+
+    node_bytes[i] = static_cast<double>(bytes[i]);
+  }
+
+  Rcpp::CharacterVector node_types = Rcpp::CharacterVector::create("JsonDouble", "JsonInt", "JsonString", "JsonArray", "JsonObject");
+
+  Rcpp::DataFrame json_nodes = Rcpp::DataFrame::create(Rcpp::Named("node_type") = node_types, Rcpp::Named("allocations") = node_counts,
+
+                                                       Rcpp::Named("bytes") = node_bytes, Rcpp::Named("stringsAsFactors") = false);
+
+  Rcpp::List res = Rcpp::List::create(Rcpp::Named("tracking") = json11::alloc_tracking(),
+
+                                      Rcpp::Named("json_nodes") = json_nodes,
+
+                                      Rcpp::Named("list_reallocations") = list_reallocations,
+
+                                      Rcpp::Named("list_realloc_bytes") = list_realloc_bytes);
+
+  if (reset) {
+
+    json11::reset_alloc_stats();
+
+    list_reallocations = list_realloc_bytes = 0.0;
+  }
+
+  return res;
+}
@@ -12,8 +12,8 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // export_From_geojson
-Rcpp::List export_From_geojson(std::string input_file, bool flatten_coords, bool average_coordinates, bool to_list);
-RcppExport SEXP _geojsonR_export_From_geojson(SEXP input_fileSEXP, SEXP flatten_coordsSEXP, SEXP average_coordinatesSEXP, SEXP to_listSEXP) {
+Rcpp::List export_From_geojson(std::string input_file, bool flatten_coords, bool average_coordinates, bool to_list, bool geometry_dump, bool lazy_coords, bool feature_bbox, double simplify_tolerance, bool profile, bool verbose, int threads);
+RcppExport SEXP _geojsonR_export_From_geojson(SEXP input_fileSEXP, SEXP flatten_coordsSEXP, SEXP average_coordinatesSEXP, SEXP to_listSEXP, SEXP geometry_dumpSEXP, SEXP lazy_coordsSEXP, SEXP feature_bboxSEXP, SEXP simplify_toleranceSEXP, SEXP profileSEXP, SEXP verboseSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -21,7 +21,35 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type flatten_coords(flatten_coordsSEXP);
     Rcpp::traits::input_parameter< bool >::type average_coordinates(average_coordinatesSEXP);
     Rcpp::traits::input_parameter< bool >::type to_list(to_listSEXP);
-    rcpp_result_gen = Rcpp::wrap(export_From_geojson(input_file, flatten_coords, average_coordinates, to_list));
+    Rcpp::traits::input_parameter< bool >::type geometry_dump(geometry_dumpSEXP);
+    Rcpp::traits::input_parameter< bool >::type lazy_coords(lazy_coordsSEXP);
+    Rcpp::traits::input_parameter< bool >::type feature_bbox(feature_bboxSEXP);
+    Rcpp::traits::input_parameter< double >::type simplify_tolerance(simplify_toleranceSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_From_geojson(input_file, flatten_coords, average_coordinates, to_list, geometry_dump, lazy_coords, feature_bbox, simplify_tolerance, profile, verbose, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_From_geojson_files
+Rcpp::List export_From_geojson_files(std::vector<std::string> input_files, bool flatten_coords, bool average_coordinates, bool to_list, bool geometry_dump, bool lazy_coords, bool feature_bbox, double simplify_tolerance, int threads, bool profile, bool verbose);
+RcppExport SEXP _geojsonR_export_From_geojson_files(SEXP input_filesSEXP, SEXP flatten_coordsSEXP, SEXP average_coordinatesSEXP, SEXP to_listSEXP, SEXP geometry_dumpSEXP, SEXP lazy_coordsSEXP, SEXP feature_bboxSEXP, SEXP simplify_toleranceSEXP, SEXP threadsSEXP, SEXP profileSEXP, SEXP verboseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type input_files(input_filesSEXP);
+    Rcpp::traits::input_parameter< bool >::type flatten_coords(flatten_coordsSEXP);
+    Rcpp::traits::input_parameter< bool >::type average_coordinates(average_coordinatesSEXP);
+    Rcpp::traits::input_parameter< bool >::type to_list(to_listSEXP);
+    Rcpp::traits::input_parameter< bool >::type geometry_dump(geometry_dumpSEXP);
+    Rcpp::traits::input_parameter< bool >::type lazy_coords(lazy_coordsSEXP);
+    Rcpp::traits::input_parameter< bool >::type feature_bbox(feature_bboxSEXP);
+    Rcpp::traits::input_parameter< double >::type simplify_tolerance(simplify_toleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_From_geojson_files(input_files, flatten_coords, average_coordinates, to_list, geometry_dump, lazy_coords, feature_bbox, simplify_tolerance, threads, profile, verbose));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -37,32 +65,52 @@ BEGIN_RCPP
 END_RCPP
 }
 // dump_geojson
-std::string dump_geojson(std::string input_data);
-RcppExport SEXP _geojsonR_dump_geojson(SEXP input_dataSEXP) {
+std::string dump_geojson(std::string input_data, int threads);
+RcppExport SEXP _geojsonR_dump_geojson(SEXP input_dataSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::string >::type input_data(input_dataSEXP);
-    rcpp_result_gen = Rcpp::wrap(dump_geojson(input_data));
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(dump_geojson(input_data, threads));
     return rcpp_result_gen;
 END_RCPP
 }
 // Features_TO_Collection
-std::string Features_TO_Collection(std::vector<std::string> feat_files_lst, std::vector<double> bbox_vec, bool verbose);
-RcppExport SEXP _geojsonR_Features_TO_Collection(SEXP feat_files_lstSEXP, SEXP bbox_vecSEXP, SEXP verboseSEXP) {
+SEXP Features_TO_Collection(std::vector<std::string> feat_files_lst, std::vector<double> bbox_vec, bool verbose, bool profile, int threads);
+RcppExport SEXP _geojsonR_Features_TO_Collection(SEXP feat_files_lstSEXP, SEXP bbox_vecSEXP, SEXP verboseSEXP, SEXP profileSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type feat_files_lst(feat_files_lstSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type bbox_vec(bbox_vecSEXP);
+    Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Features_TO_Collection(feat_files_lst, bbox_vec, verbose, profile, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// splice_Features_TO_Collection
+SEXP splice_Features_TO_Collection(std::vector<std::string> feat_files_lst, std::vector<double> bbox_vec, bool compute_bbox, std::string path_to_file, int threads, bool verbose, bool profile);
+RcppExport SEXP _geojsonR_splice_Features_TO_Collection(SEXP feat_files_lstSEXP, SEXP bbox_vecSEXP, SEXP compute_bboxSEXP, SEXP path_to_fileSEXP, SEXP threadsSEXP, SEXP verboseSEXP, SEXP profileSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::vector<std::string> >::type feat_files_lst(feat_files_lstSEXP);
     Rcpp::traits::input_parameter< std::vector<double> >::type bbox_vec(bbox_vecSEXP);
+    Rcpp::traits::input_parameter< bool >::type compute_bbox(compute_bboxSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
     Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
-    rcpp_result_gen = Rcpp::wrap(Features_TO_Collection(feat_files_lst, bbox_vec, verbose));
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    rcpp_result_gen = Rcpp::wrap(splice_Features_TO_Collection(feat_files_lst, bbox_vec, compute_bbox, path_to_file, threads, verbose, profile));
     return rcpp_result_gen;
 END_RCPP
 }
 // export_From_geojson_schema
-Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMETRY_OBJECT_NAME, bool average_coordinates, bool to_list);
-RcppExport SEXP _geojsonR_export_From_geojson_schema(SEXP input_fileSEXP, SEXP GEOMETRY_OBJECT_NAMESEXP, SEXP average_coordinatesSEXP, SEXP to_listSEXP) {
+Rcpp::List export_From_geojson_schema(std::string input_file, std::string GEOMETRY_OBJECT_NAME, bool average_coordinates, bool to_list, bool geometry_dump, bool lazy_coords, bool profile);
+RcppExport SEXP _geojsonR_export_From_geojson_schema(SEXP input_fileSEXP, SEXP GEOMETRY_OBJECT_NAMESEXP, SEXP average_coordinatesSEXP, SEXP to_listSEXP, SEXP geometry_dumpSEXP, SEXP lazy_coordsSEXP, SEXP profileSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -70,33 +118,58 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< std::string >::type GEOMETRY_OBJECT_NAME(GEOMETRY_OBJECT_NAMESEXP);
     Rcpp::traits::input_parameter< bool >::type average_coordinates(average_coordinatesSEXP);
     Rcpp::traits::input_parameter< bool >::type to_list(to_listSEXP);
-    rcpp_result_gen = Rcpp::wrap(export_From_geojson_schema(input_file, GEOMETRY_OBJECT_NAME, average_coordinates, to_list));
+    Rcpp::traits::input_parameter< bool >::type geometry_dump(geometry_dumpSEXP);
+    Rcpp::traits::input_parameter< bool >::type lazy_coords(lazy_coordsSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_From_geojson_schema(input_file, GEOMETRY_OBJECT_NAME, average_coordinates, to_list, geometry_dump, lazy_coords, profile));
     return rcpp_result_gen;
 END_RCPP
 }
 // list_files
-std::vector<std::string> list_files(const std::string& path, bool full_path);
-RcppExport SEXP _geojsonR_list_files(SEXP pathSEXP, SEXP full_pathSEXP) {
+std::vector<std::string> list_files(const std::string& path, bool full_path, bool recursive, std::vector<std::string> extensions, int threads);
+RcppExport SEXP _geojsonR_list_files(SEXP pathSEXP, SEXP full_pathSEXP, SEXP recursiveSEXP, SEXP extensionsSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type path(pathSEXP);
     Rcpp::traits::input_parameter< bool >::type full_path(full_pathSEXP);
-    rcpp_result_gen = Rcpp::wrap(list_files(path, full_path));
+    Rcpp::traits::input_parameter< bool >::type recursive(recursiveSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type extensions(extensionsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(list_files(path, full_path, recursive, extensions, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// list_files_sizes
+Rcpp::List list_files_sizes(const std::string& path, bool recursive, std::vector<std::string> extensions, int threads);
+RcppExport SEXP _geojsonR_list_files_sizes(SEXP pathSEXP, SEXP recursiveSEXP, SEXP extensionsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< bool >::type recursive(recursiveSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type extensions(extensionsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(list_files_sizes(path, recursive, extensions, threads));
     return rcpp_result_gen;
 END_RCPP
 }
 // merge_json
-void merge_json(const std::string& input_folder, std::string output_file, std::string concat_delimiter, bool verbose);
-RcppExport SEXP _geojsonR_merge_json(SEXP input_folderSEXP, SEXP output_fileSEXP, SEXP concat_delimiterSEXP, SEXP verboseSEXP) {
+SEXP merge_json(const std::string& input_folder, std::string output_file, std::string concat_delimiter, bool verbose, bool recursive, std::vector<std::string> extensions, int threads, bool profile);
+RcppExport SEXP _geojsonR_merge_json(SEXP input_folderSEXP, SEXP output_fileSEXP, SEXP concat_delimiterSEXP, SEXP verboseSEXP, SEXP recursiveSEXP, SEXP extensionsSEXP, SEXP threadsSEXP, SEXP profileSEXP) {
 BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type input_folder(input_folderSEXP);
     Rcpp::traits::input_parameter< std::string >::type output_file(output_fileSEXP);
     Rcpp::traits::input_parameter< std::string >::type concat_delimiter(concat_delimiterSEXP);
     Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
-    merge_json(input_folder, output_file, concat_delimiter, verbose);
-    return R_NilValue;
+    Rcpp::traits::input_parameter< bool >::type recursive(recursiveSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type extensions(extensionsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    rcpp_result_gen = Rcpp::wrap(merge_json(input_folder, output_file, concat_delimiter, verbose, recursive, extensions, threads, profile));
+    return rcpp_result_gen;
 END_RCPP
 }
 // DATA_TYPE
@@ -110,48 +183,39 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
-// inner_coords
-std::string inner_coords(Rcpp::List geom_lst, int z, bool polygon_interior);
-RcppExport SEXP _geojsonR_inner_coords(SEXP geom_lstSEXP, SEXP zSEXP, SEXP polygon_interiorSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< Rcpp::List >::type geom_lst(geom_lstSEXP);
-    Rcpp::traits::input_parameter< int >::type z(zSEXP);
-    Rcpp::traits::input_parameter< bool >::type polygon_interior(polygon_interiorSEXP);
-    rcpp_result_gen = Rcpp::wrap(inner_coords(geom_lst, z, polygon_interior));
-    return rcpp_result_gen;
-END_RCPP
-}
-// Polygon_with_interior_rings
-std::string Polygon_with_interior_rings(Rcpp::List geom_lst, int i, bool verbose);
-RcppExport SEXP _geojsonR_Polygon_with_interior_rings(SEXP geom_lstSEXP, SEXP iSEXP, SEXP verboseSEXP) {
+// SAVE_R_list_Features_2_FeatureCollection
+SEXP SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string path_to_file, bool verbose, double simplify_tolerance, int precision, int threads, bool profile, bool stream);
+RcppExport SEXP _geojsonR_SAVE_R_list_Features_2_FeatureCollection(SEXP xSEXP, SEXP path_to_fileSEXP, SEXP verboseSEXP, SEXP simplify_toleranceSEXP, SEXP precisionSEXP, SEXP threadsSEXP, SEXP profileSEXP, SEXP streamSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< Rcpp::List >::type geom_lst(geom_lstSEXP);
-    Rcpp::traits::input_parameter< int >::type i(iSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type x(xSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
     Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
-    rcpp_result_gen = Rcpp::wrap(Polygon_with_interior_rings(geom_lst, i, verbose));
+    Rcpp::traits::input_parameter< double >::type simplify_tolerance(simplify_toleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< bool >::type stream(streamSEXP);
+    rcpp_result_gen = Rcpp::wrap(SAVE_R_list_Features_2_FeatureCollection(x, path_to_file, verbose, simplify_tolerance, precision, threads, profile, stream));
     return rcpp_result_gen;
 END_RCPP
 }
-// SAVE_R_list_Features_2_FeatureCollection
-std::string SAVE_R_list_Features_2_FeatureCollection(Rcpp::List x, std::string path_to_file, bool verbose);
-RcppExport SEXP _geojsonR_SAVE_R_list_Features_2_FeatureCollection(SEXP xSEXP, SEXP path_to_fileSEXP, SEXP verboseSEXP) {
+// export_alloc_stats
+Rcpp::List export_alloc_stats(int enable, bool reset);
+RcppExport SEXP _geojsonR_export_alloc_stats(SEXP enableSEXP, SEXP resetSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< Rcpp::List >::type x(xSEXP);
-    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
-    Rcpp::traits::input_parameter< bool >::type verbose(verboseSEXP);
-    rcpp_result_gen = Rcpp::wrap(SAVE_R_list_Features_2_FeatureCollection(x, path_to_file, verbose));
+    Rcpp::traits::input_parameter< int >::type enable(enableSEXP);
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_alloc_stats(enable, reset));
     return rcpp_result_gen;
 END_RCPP
 }
 // export_To_GeoJson
-Rcpp::List export_To_GeoJson(std::string geometry_object, std::vector<double> data_POINTS, std::vector<std::vector<double>> data_ARRAYS, std::vector<std::vector<std::vector<double>>> data_ARRAY_ARRAYS, std::vector<std::vector<std::vector<std::vector<double>>>> data_POLYGON_ARRAYS, bool stringify);
-RcppExport SEXP _geojsonR_export_To_GeoJson(SEXP geometry_objectSEXP, SEXP data_POINTSSEXP, SEXP data_ARRAYSSEXP, SEXP data_ARRAY_ARRAYSSEXP, SEXP data_POLYGON_ARRAYSSEXP, SEXP stringifySEXP) {
+Rcpp::List export_To_GeoJson(std::string geometry_object, std::vector<double> data_POINTS, std::vector<std::vector<double>> data_ARRAYS, std::vector<std::vector<std::vector<double>>> data_ARRAY_ARRAYS, std::vector<std::vector<std::vector<std::vector<double>>>> data_POLYGON_ARRAYS, bool stringify, double simplify_tolerance);
+RcppExport SEXP _geojsonR_export_To_GeoJson(SEXP geometry_objectSEXP, SEXP data_POINTSSEXP, SEXP data_ARRAYSSEXP, SEXP data_ARRAY_ARRAYSSEXP, SEXP data_POLYGON_ARRAYSSEXP, SEXP stringifySEXP, SEXP simplify_toleranceSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -161,7 +225,22 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< std::vector<std::vector<std::vector<double>>> >::type data_ARRAY_ARRAYS(data_ARRAY_ARRAYSSEXP);
     Rcpp::traits::input_parameter< std::vector<std::vector<std::vector<std::vector<double>>>> >::type data_POLYGON_ARRAYS(data_POLYGON_ARRAYSSEXP);
     Rcpp::traits::input_parameter< bool >::type stringify(stringifySEXP);
-    rcpp_result_gen = Rcpp::wrap(export_To_GeoJson(geometry_object, data_POINTS, data_ARRAYS, data_ARRAY_ARRAYS, data_POLYGON_ARRAYS, stringify));
+    Rcpp::traits::input_parameter< double >::type simplify_tolerance(simplify_toleranceSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_To_GeoJson(geometry_object, data_POINTS, data_ARRAYS, data_ARRAY_ARRAYS, data_POLYGON_ARRAYS, stringify, simplify_tolerance));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_To_GeoJson_matrix
+Rcpp::List export_To_GeoJson_matrix(std::string geometry_object, SEXP data, bool stringify, double simplify_tolerance);
+RcppExport SEXP _geojsonR_export_To_GeoJson_matrix(SEXP geometry_objectSEXP, SEXP dataSEXP, SEXP stringifySEXP, SEXP simplify_toleranceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type geometry_object(geometry_objectSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< bool >::type stringify(stringifySEXP);
+    Rcpp::traits::input_parameter< double >::type simplify_tolerance(simplify_toleranceSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_To_GeoJson_matrix(geometry_object, data, stringify, simplify_tolerance));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -192,15 +271,174 @@ BEGIN_RCPP
 END_RCPP
 }
 // Feature_collection_Obj
-Rcpp::List Feature_collection_Obj(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify);
-RcppExport SEXP _geojsonR_Feature_collection_Obj(SEXP geometry_object_namesSEXP, SEXP geometry_objectsSEXP, SEXP stringifySEXP) {
+Rcpp::List Feature_collection_Obj(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify, std::string path_to_file);
+RcppExport SEXP _geojsonR_Feature_collection_Obj(SEXP geometry_object_namesSEXP, SEXP geometry_objectsSEXP, SEXP stringifySEXP, SEXP path_to_fileSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::vector<std::string> >::type geometry_object_names(geometry_object_namesSEXP);
     Rcpp::traits::input_parameter< Rcpp::List >::type geometry_objects(geometry_objectsSEXP);
     Rcpp::traits::input_parameter< bool >::type stringify(stringifySEXP);
-    rcpp_result_gen = Rcpp::wrap(Feature_collection_Obj(geometry_object_names, geometry_objects, stringify));
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(Feature_collection_Obj(geometry_object_names, geometry_objects, stringify, path_to_file));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_GeoJson_Seq
+int export_GeoJson_Seq(Rcpp::List features, std::string path_to_file, bool append, bool rs_separator, int precision, double buffer_size);
+RcppExport SEXP _geojsonR_export_GeoJson_Seq(SEXP featuresSEXP, SEXP path_to_fileSEXP, SEXP appendSEXP, SEXP rs_separatorSEXP, SEXP precisionSEXP, SEXP buffer_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type features(featuresSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
+    Rcpp::traits::input_parameter< bool >::type append(appendSEXP);
+    Rcpp::traits::input_parameter< bool >::type rs_separator(rs_separatorSEXP);
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< double >::type buffer_size(buffer_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_GeoJson_Seq(features, path_to_file, append, rs_separator, precision, buffer_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_fc_writer_open
+SEXP export_fc_writer_open(std::string path_to_file, std::vector<double> bbox_vec, bool update_bbox, int precision);
+RcppExport SEXP _geojsonR_export_fc_writer_open(SEXP path_to_fileSEXP, SEXP bbox_vecSEXP, SEXP update_bboxSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type bbox_vec(bbox_vecSEXP);
+    Rcpp::traits::input_parameter< bool >::type update_bbox(update_bboxSEXP);
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_fc_writer_open(path_to_file, bbox_vec, update_bbox, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_fc_writer_append
+int export_fc_writer_append(SEXP handle, Rcpp::List features);
+RcppExport SEXP _geojsonR_export_fc_writer_append(SEXP handleSEXP, SEXP featuresSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type features(featuresSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_fc_writer_append(handle, features));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_fc_writer_close
+int export_fc_writer_close(SEXP handle);
+RcppExport SEXP _geojsonR_export_fc_writer_close(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_fc_writer_close(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// long_format_offsets
+Rcpp::List long_format_offsets(Rcpp::List group_codes);
+RcppExport SEXP _geojsonR_long_format_offsets(SEXP group_codesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type group_codes(group_codesSEXP);
+    rcpp_result_gen = Rcpp::wrap(long_format_offsets(group_codes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ragged_geometries_list
+Rcpp::List ragged_geometries_list(std::string geometry_type, Rcpp::NumericMatrix coords, Rcpp::List offsets);
+RcppExport SEXP _geojsonR_ragged_geometries_list(SEXP geometry_typeSEXP, SEXP coordsSEXP, SEXP offsetsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type geometry_type(geometry_typeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type coords(coordsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type offsets(offsetsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ragged_geometries_list(geometry_type, coords, offsets));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_DataFrame_FeatureCollection
+SEXP export_DataFrame_FeatureCollection(Rcpp::List data, Rcpp::List geometry, std::vector<std::string> geometry_type, bool ragged, int id_idx, std::string path_to_file, int precision, bool profile);
+RcppExport SEXP _geojsonR_export_DataFrame_FeatureCollection(SEXP dataSEXP, SEXP geometrySEXP, SEXP geometry_typeSEXP, SEXP raggedSEXP, SEXP id_idxSEXP, SEXP path_to_fileSEXP, SEXP precisionSEXP, SEXP profileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type geometry(geometrySEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type geometry_type(geometry_typeSEXP);
+    Rcpp::traits::input_parameter< bool >::type ragged(raggedSEXP);
+    Rcpp::traits::input_parameter< int >::type id_idx(id_idxSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path_to_file(path_to_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_DataFrame_FeatureCollection(data, geometry, geometry_type, ragged, id_idx, path_to_file, precision, profile));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_point_in_polygon
+Rcpp::IntegerVector export_point_in_polygon(Rcpp::NumericMatrix points, Rcpp::List features, int threads);
+RcppExport SEXP _geojsonR_export_point_in_polygon(SEXP pointsSEXP, SEXP featuresSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type points(pointsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type features(featuresSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_point_in_polygon(points, features, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_point_in_polygon_flat
+Rcpp::IntegerVector export_point_in_polygon_flat(Rcpp::NumericMatrix points, Rcpp::NumericMatrix coords, int threads);
+RcppExport SEXP _geojsonR_export_point_in_polygon_flat(SEXP pointsSEXP, SEXP coordsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type points(pointsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type coords(coordsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_point_in_polygon_flat(points, coords, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_spatial_index
+SEXP export_spatial_index(Rcpp::NumericMatrix feature_bbox, int node_size);
+RcppExport SEXP _geojsonR_export_spatial_index(SEXP feature_bboxSEXP, SEXP node_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type feature_bbox(feature_bboxSEXP);
+    Rcpp::traits::input_parameter< int >::type node_size(node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_spatial_index(feature_bbox, node_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_query_bbox
+Rcpp::IntegerVector export_query_bbox(SEXP layer, std::vector<double> bbox);
+RcppExport SEXP _geojsonR_export_query_bbox(SEXP layerSEXP, SEXP bboxSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type layer(layerSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type bbox(bboxSEXP);
+    rcpp_result_gen = Rcpp::wrap(export_query_bbox(layer, bbox));
+    return rcpp_result_gen;
+END_RCPP
+}
+// export_query_point
+Rcpp::IntegerVector export_query_point(SEXP layer, double x, double y);
+RcppExport SEXP _geojsonR_export_query_point(SEXP layerSEXP, SEXP xSEXP, SEXP ySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type layer(layerSEXP);
+    Rcpp::traits::input_parameter< double >::type x(xSEXP);
+    Rcpp::traits::input_parameter< double >::type y(ySEXP);
+    rcpp_result_gen = Rcpp::wrap(export_query_point(layer, x, y));
     return rcpp_result_gen;
 END_RCPP
 }
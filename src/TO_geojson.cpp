@@ -24,67 +24,186 @@
 #include <sstream>
 #include <string>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 
 #include <R.h>
 #include <Rinternals.h>
 
-#include "json11.h"
+#include "simplify_geometry.h"
+#include "geojson_writer.h"
 
 
 
+// simplification of the positions of the matrices [ the rows that are kept are saved in the 'Matrix_View' ]
+//
+
+inline void simplify_nested(Matrix_View &data, double tolerance, bool ring) {
+
+  if (data.ncol < 2) return;                                                       // invalid positions, the data are kept as they are
+
+  std::vector<int> keep = simplify_positions(data.data, data.data + data.nrow, data.nrow, tolerance, ring);
+
+  if (static_cast<int>(keep.size()) < data.nrow) data.keep.swap(keep);
+}
+
+
+inline void simplify_nested(std::vector<Matrix_View> &data, double tolerance, bool ring) {
+
+  for (auto &item : data) simplify_nested(item, tolerance, ring);
+}
+
+
+// the rings of a 'Polygon' are simplified together [ see 'simplify_polygon()' ]
+//
+
+inline void simplify_rings(std::vector<Matrix_View> &data, double tolerance) {
+
+  std::vector<const double *> x(data.size()), y(data.size());
+
+  std::vector<int> n(data.size());
+
+  for (size_t k = 0; k < data.size(); k++) {
+
+    if (data[k].ncol < 2) return;                                                  // invalid positions, the data are kept as they are
+
+    x[k] = data[k].data;
+
+    y[k] = data[k].data + data[k].nrow;
+
+    n[k] = data[k].nrow;
+  }
+
+  std::vector<std::vector<int> > keep = simplify_polygon(x, y, n, tolerance);
+
+  for (size_t k = 0; k < data.size(); k++) {
+
+    if (static_cast<int>(keep[k].size()) < data[k].nrow) data[k].keep.swap(keep[k]);
+  }
+}
+
+
+inline void simplify_rings(std::vector<std::vector<Matrix_View> > &data, double tolerance) {
+
+  for (auto &item : data) simplify_rings(item, tolerance);
+}
+
+
+// the "coordinates" of the output list. The nested std::vectors are converted to (nested) lists of numeric vectors, whereas the matrices are returned as
+// they are ( without a copy ), unless rows were removed by the simplification
+//
+
+template<class T>
+inline SEXP coordinates_R(const T &data) {
+
+  return Rcpp::wrap(data);
+}
+
+
+inline SEXP coordinates_R(const Matrix_View &data) {
+
+  if (data.keep.empty()) return data.r_data;
+
+  Rcpp::NumericMatrix res(data.size(), data.ncol);
+
+  for (int i = 0; i < data.size(); i++) {
+
+    for (int j = 0; j < data.ncol; j++) {
+
+      res(i, j) = data.data[data.row(i) + static_cast<R_xlen_t>(j) * data.nrow];
+    }
+  }
+
+  return res;
+}
+
+
+inline SEXP coordinates_R(const std::vector<Matrix_View> &data) {
+
+  Rcpp::List res(data.size());
+
+  for (size_t i = 0; i < data.size(); i++) res[i] = coordinates_R(data[i]);
+
+  return res;
+}
+
+
+inline SEXP coordinates_R(const std::vector<std::vector<Matrix_View> > &data) {
+
+  Rcpp::List res(data.size());
+
+  for (size_t i = 0; i < data.size(); i++) res[i] = coordinates_R(data[i]);
+
+  return res;
+}
+
+
 // Classes to build GeoJson-Geometries
 //
+// T is either a nested std::vector of the coordinates or a ( nested std::vector of ) 'Matrix_View', which reads the positions directly from the R matrices
+//
 
 template<class T>
 class GeoJson_Geometries {
 
-public:
+private:
 
-  GeoJson_Geometries() { }
+  double simplify_tolerance;                              // Douglas-Peucker tolerance [ 0.0 : no simplification ]
 
+public:
 
-  // inner geometry object (json11)
-  //
+  GeoJson_Geometries(double tolerance = 0.0) : simplify_tolerance(tolerance) { }
 
-  json11::Json Inner_GeoJson(std::string geometry_object, T data) {
 
-    json11::Json::array OBJ;
+  // simplification of the coordinates [ 'LineString', 'MultiLineString', 'Polygon' and 'MultiPolygon' ]. The rings of polygons keep at least 4 positions and
+  // remain valid rings [ see 'simplify_polygon()' ]
+  //
 
-    for (unsigned int i = 0; i < data.size(); i++) {
+  void Simplify(std::string geometry_object, T &data) {
 
-      OBJ.push_back(data[i]);
-    }
+    if (simplify_tolerance <= 0.0 || geometry_object == "Point" || geometry_object == "MultiPoint") return;
 
-    json11::Json geo_json = json11::Json::object {
+    if (geometry_object == "Polygon" || geometry_object == "MultiPolygon") {
 
-      { "type", geometry_object },
+      simplify_rings(data, simplify_tolerance);}
 
-      { "coordinates", OBJ },
-    };
+    else {
 
-    return geo_json;
+      simplify_nested(data, simplify_tolerance, false);
+    }
   }
 
 
   // geometry-object : "Point", "MultiPoint", "LineString", "MultiLineString", "Polygon", "MultiPolygon"
+  // the json-dump is written directly from the (nested) std::vector of the coordinates [ GeoJson_Writer ]
   //
 
   Rcpp::List To_Geom_Obj(std::string geometry_object, T data, bool stringify = false) {
 
     Rcpp::List RES;
 
+    Simplify(geometry_object, data);
+
     if (stringify) {
 
-      json11::Json geo_json = Inner_GeoJson(geometry_object, data);
+      GeoJson_Writer writer;
+
+      writer.put("{\"coordinates\": ");
+
+      writer.put_nested(data);
 
-      std::string json_str =  geo_json.dump();
+      writer.put(", \"type\": ");
 
-      RES["json_dump"] = json_str;
+      writer.put_string(geometry_object);
+
+      writer.put('}');
+
+      RES["json_dump"] = writer.str();
     }
 
     RES["type"] = geometry_object;
 
-    RES["coordinates"] = data;
+    RES["coordinates"] = coordinates_R(data);
 
     return RES;
   }
@@ -97,68 +216,95 @@ public:
 
 // Class to build : 'Geometry-Collection', 'Feature', and 'Feature-Collection'
 //
+// if stringify = TRUE then the json-dump is written directly from the R objects to a single output buffer ( OR to a file ) using the 'GeoJson_Writer'. The
+// keys of the json-objects are written sorted, therefore the output is the same as the dump of the corresponding json11 object
+//
 
 
 class GeoJson_Collections {
 
-public:
+private:
 
-  // array of geometry-objects
+  // indices of the items sorted by name [ if a name is duplicated then the last item is kept ]
   //
 
-  json11::Json::array array_geometry_collection(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects) {
+  std::vector<int> sorted_members(const std::vector<std::string> &names) {
 
-    json11::Json::array array_geometries;
+    std::vector<int> order(names.size());
 
-    for (unsigned int i = 0; i < geometry_object_names.size(); i++) {
+    for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
 
-      json11::Json geo_json;
+    std::stable_sort(order.begin(), order.end(), [&names](int a, int b) { return names[a] < names[b]; });
 
-      if (geometry_object_names[i] == "Point") {
+    std::vector<int> res;
 
-        GeoJson_Geometries<std::vector<double>> gjg;
+    res.reserve(order.size());
 
-        std::vector<double> tmp_dat = geometry_objects[i];
+    for (unsigned int k = 0; k < order.size(); k++) {
 
-        geo_json = gjg.Inner_GeoJson(geometry_object_names[i], tmp_dat);
-      }
+      if (k + 1 < order.size() && names[order[k]] == names[order[k + 1]]) continue;
 
-      else if (geometry_object_names[i] == "MultiPoint" || geometry_object_names[i] == "LineString") {
+      res.push_back(order[k]);
+    }
 
-        GeoJson_Geometries<std::vector<std::vector<double>>> gjg;
+    return res;
+  }
 
-        std::vector<std::vector<double>> tmp_dat = geometry_objects[i];
 
-        geo_json = gjg.Inner_GeoJson(geometry_object_names[i], tmp_dat);
-      }
+  // writes the key of a member of a json-object ( the separator is added if it's not the first member )
+  //
 
-      else if (geometry_object_names[i] == "MultiLineString" || geometry_object_names[i] == "Polygon") {
+  void member(GeoJson_Writer &writer, const char *name, bool &first) {
 
-        GeoJson_Geometries<std::vector<std::vector<std::vector<double>>>> gjg;
+    if (!first) writer.sep();
 
-        std::vector<std::vector<std::vector<double>>> tmp_dat = geometry_objects[i];
+    writer.key(name);
 
-        geo_json = gjg.Inner_GeoJson(geometry_object_names[i], tmp_dat);
-      }
+    first = false;
+  }
 
-      else if (geometry_object_names[i] == "MultiPolygon") {
 
-        GeoJson_Geometries<std::vector<std::vector<std::vector<std::vector<double>>>>> gjg;
+public:
 
-        std::vector<std::vector<std::vector<std::vector<double>>>> tmp_dat = geometry_objects[i];
+  // geometry-object : {"coordinates": [...], "type": "..."}
+  //
 
-        geo_json = gjg.Inner_GeoJson(geometry_object_names[i], tmp_dat);
-      }
+  void inner_geometry(GeoJson_Writer &writer, const std::string &geometry_object, SEXP data) {
 
-      else {
+    int depth = geometry_type_depth(geometry_object);
 
-        Rcpp::stop("invalid GeoJson geometry object --> array_geometry_collection() function");
-      }
+    if (depth == 0) {
+
+      Rcpp::stop("invalid GeoJson geometry object --> array_geometry_collection() function");
+    }
+
+    writer.put("{\"coordinates\": ");
+
+    writer.put_coordinates(data, depth);
+
+    writer.put(", \"type\": ");
+
+    writer.put_string(geometry_object);
+
+    writer.put('}');
+  }
+
+
+  // array of geometry-objects
+  //
+
+  void array_geometry_collection(GeoJson_Writer &writer, std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects) {
+
+    writer.put('[');
 
-      array_geometries.push_back(geo_json);
+    for (unsigned int i = 0; i < geometry_object_names.size(); i++) {
+
+      if (i > 0) writer.sep();
+
+      inner_geometry(writer, geometry_object_names[i], geometry_objects[i]);
     }
 
-    return array_geometries;
+    writer.put(']');
   }
 
 
@@ -173,19 +319,21 @@ public:
 
     if (stringify) {
 
-      json11::Json::array ARRAY = array_geometry_collection(geometry_object_names, geometry_objects);
+      GeoJson_Writer writer;
+
+      writer.reserve(estimate_json_size(geometry_objects));
 
-      json11::Json geom_OBJECTS = json11::Json::object {
+      writer.put("{\"geometries\": ");
 
-        { "type", tmp_nam },
+      array_geometry_collection(writer, geometry_object_names, geometry_objects);
 
-        { "geometries", ARRAY },
+      writer.put(", \"type\": ");
 
-      };
+      writer.put_string(tmp_nam);
 
-      std::string json_str =  geom_OBJECTS.dump();
+      writer.put('}');
 
-      RES["json_dump"] = json_str;
+      RES["json_dump"] = writer.str();
     }
 
     RES["type"] = tmp_nam;
@@ -197,170 +345,177 @@ public:
 
 
   // recursive function for the 'properties' member of the 'Feature' object [ if stringify = TRUE ]
+  // a named list is written as a json-object and an unnamed list as a json-array. Vectors of length 1 are written as json-values and vectors of other length as arrays
   // For, the 'TYPEOF()', 'LENGTH', 'REALSXP', 'LGLSXP etc. SEE :
   // http://adv-r.had.co.nz/C-interface.html, https://github.com/hadley/pryr/blob/master/src/typename.cpp,
   // https://github.com/hadley/r-internals/blob/master/vectors.md, http://gallery.rcpp.org/articles/rcpp-wrap-and-recurse/
   //
 
-  json11::Json typeof_item(Rcpp::List rec_prop) {
-
-    json11::Json::object properties_OBJ;
-
-    std::vector<std::string> prop_nams = rec_prop.attr("names");
-
-    unsigned int REC_SIZE = rec_prop.size();
+  void typeof_item(GeoJson_Writer &writer, SEXP item) {
 
-    for (unsigned int f = 0; f < REC_SIZE; f++) {
+    int type = TYPEOF(item);
 
-      std::string tmp_nam = prop_nams[f];
+    if (type == VECSXP) {
 
-      int length_item = LENGTH(rec_prop[f]);                          // distinction between 'float' and 'vector of floats' using LENGTH()
+      R_xlen_t REC_SIZE = Rf_xlength(item);
 
-      if (length_item == 1) {
+      SEXP prop_nams = Rf_getAttrib(item, R_NamesSymbol);
 
-        if (TYPEOF(rec_prop[f]) == REALSXP) {
+      if (REC_SIZE == 0) {
 
-          double tmp_dbl = Rcpp::as<double>(rec_prop[f]);
+        writer.put("{}");}                                                 // empty object if the list is empty
 
-          properties_OBJ[tmp_nam] = json11::Json(tmp_dbl);}
-        
-        else if (TYPEOF(rec_prop[f]) == INTSXP) {
-          
-          int tmp_dbl_int = Rcpp::as<int>(rec_prop[f]);
-          
-          properties_OBJ[tmp_nam] = json11::Json(tmp_dbl_int);}
+      else if (prop_nams == R_NilValue) {
 
-        else if (TYPEOF(rec_prop[f]) == LGLSXP) {
+        writer.put('[');
 
-          bool tmp_bool = rec_prop[f];
+        for (R_xlen_t f = 0; f < REC_SIZE; f++) {
 
-          properties_OBJ[tmp_nam] = json11::Json(tmp_bool);}
+          if (f > 0) writer.sep();
 
-        else if (TYPEOF(rec_prop[f]) == STRSXP) {
+          typeof_item(writer, VECTOR_ELT(item, f));
+        }
 
-          std::string tmp_str = Rcpp::as<std::string>(rec_prop[f]);
+        writer.put(']');
+      }
 
-          properties_OBJ[tmp_nam] = json11::Json(tmp_str);}
+      else {
 
-        else if (TYPEOF(rec_prop[f]) == NILSXP) {
+        std::vector<std::string> tmp_nams = Rcpp::as<std::vector<std::string> >(prop_nams);
 
-          std::string tmp_str = "null";
+        std::vector<int> order = sorted_members(tmp_nams);
 
-          properties_OBJ[tmp_nam] = json11::Json(tmp_str);}
+        writer.put('{');
 
-        else if (TYPEOF(rec_prop[f]) == VECSXP) {
+        for (unsigned int k = 0; k < order.size(); k++) {
 
-          Rcpp::List tmp_lst = rec_prop[f];
+          if (k > 0) writer.sep();
 
-          properties_OBJ[tmp_nam] = typeof_item(tmp_lst);}
+          writer.put_string(tmp_nams[order[k]]);
 
-        else {
+          writer.put(": ");
 
-          Rcpp::stop("invalid Json object of length == 1 --> typeof_item() function");
+          typeof_item(writer, VECTOR_ELT(item, order[k]));
         }
+
+        writer.put('}');
       }
+    }
 
-      else {
+    else if (type == REALSXP || type == INTSXP || type == LGLSXP || type == STRSXP) {
 
-        if (TYPEOF(rec_prop[f]) == REALSXP) {
+      if (Rf_xlength(item) == 1) {                                         // distinction between 'float' and 'vector of floats' using the length
 
-          std::vector<double> arr_vec = Rcpp::as<std::vector<double>>(rec_prop[f]);
+        writer.put_atomic_item(item, 0);}
 
-          properties_OBJ[tmp_nam] = json11::Json(arr_vec);}
-        
-        else if (TYPEOF(rec_prop[f]) == INTSXP) {
-          
-          std::vector<int> arr_vec_int = Rcpp::as<std::vector<int>>(rec_prop[f]);
-          
-          properties_OBJ[tmp_nam] = json11::Json(arr_vec_int);}
+      else {
 
-        else if (TYPEOF(rec_prop[f]) == VECSXP) {
+        writer.put_atomic_array(item);
+      }
+    }
 
-          Rcpp::List tmp_lst = rec_prop[f];
+    else if (type == NILSXP) {
 
-          properties_OBJ[tmp_nam] = typeof_item(tmp_lst);}
+      writer.put_null();}
 
-        else {
+    else {
 
-          Rcpp::stop("invalid Json object of length > 1 --> typeof_item() function");
-        }
-      }
+      Rcpp::stop("invalid Json object --> typeof_item() function");
     }
-
-    return properties_OBJ;
   }
 
 
-  // inner 'json11::Json::object' function for the 'properties' member of the 'Feature' object [ if stringify = TRUE ]
+  // 'Feature' object [ if stringify = TRUE ]. The members are written in the order : "bbox", "geometry", "id", "properties", "type"
   //
 
-  json11::Json::object inner_Feature(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, std::string Feature_name) {
-
-    json11::Json::object feature_OBJ;                                      // build the Json::object incrementally
+  void inner_Feature(GeoJson_Writer &writer, std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, std::string Feature_name) {
 
-    feature_OBJ["type"] = Feature_name;
+    int idx_bbox = -1, idx_geometry = -1, idx_id = -1, idx_properties = -1;
 
     for (unsigned int i = 0; i < geometry_object_names.size(); i++) {
 
       if (geometry_object_names[i] == "id") {
 
-        if (TYPEOF(geometry_objects[i]) == STRSXP) {
+        idx_id = i;}
 
-          std::string tmp_id = Rcpp::as<std::string>(geometry_objects["id"]);
+      else if (geometry_object_names[i] == "bbox") {
 
-          feature_OBJ["id"] = json11::Json(tmp_id);}
+        idx_bbox = i;}
 
-        else if (TYPEOF(geometry_objects[i]) == REALSXP) {
+      else if (geometry_object_names[i] == "geometry") {
 
-          double tmp_id = Rcpp::as<double>(geometry_objects["id"]);
+        idx_geometry = i;}
 
-          feature_OBJ["id"] = json11::Json(tmp_id);}
+      else if (geometry_object_names[i] == "properties") {
 
-        else {
+        idx_properties = i;}
 
-          Rcpp::stop("the 'id' member should be either a character string or a numeric value --> inner_Feature() function");
-        }
+      else if (geometry_object_names[i] != "type") {                       // the 'type' member is written using the 'Feature_name'
+
+        Rcpp::stop("invalid member of the Feature geometry object --> inner_Feature() function");
       }
+    }
 
-      else if (geometry_object_names[i] == "bbox") {
+    bool first = true;
 
-        std::vector<double> bbox_vec = geometry_objects["bbox"];
+    writer.put('{');
 
-        feature_OBJ["bbox"] = json11::Json(bbox_vec);}
+    if (idx_bbox != -1) {
 
-      else if (geometry_object_names[i] == "geometry") {
+      member(writer, "bbox", first);
 
-        Rcpp::List tmp_lst = geometry_objects[i];
+      writer.put_coordinates(geometry_objects[idx_bbox]);
+    }
 
-        std::vector<std::string> tmp_lst_nams = tmp_lst.attr("names");
+    if (idx_geometry != -1) {
 
-        json11::Json::array tmp_lst_array = array_geometry_collection(tmp_lst_nams, geometry_objects[i]);      // std::vector, Rcpp::List as input
+      Rcpp::List tmp_lst = geometry_objects[idx_geometry];
 
-        feature_OBJ["geometry"] = json11::Json(tmp_lst_array[0]);}                                              // extract the object from the array [ first array element ]
+      if (tmp_lst.size() == 0) {
 
-      else if (geometry_object_names[i] == "properties") {
+        Rcpp::stop("the 'geometry' member of the Feature object is empty --> inner_Feature() function");
+      }
 
-        json11::Json::object properties_OBJ;                               // initialize second json-object for properties;
+      std::vector<std::string> tmp_lst_nams = tmp_lst.attr("names");
 
-        Rcpp::List tmp_prop = geometry_objects[i];
+      member(writer, "geometry", first);
 
-        if (tmp_prop.size() == 0) {
+      if (tmp_lst.containsElementNamed("type") && tmp_lst.containsElementNamed("coordinates")) {          // the format of the 'FROM_GeoJson' output
 
-          feature_OBJ["properties"] = json11::Json(properties_OBJ);}      // empty object if Rcpp::List is empty
+        inner_geometry(writer, Rcpp::as<std::string>(tmp_lst["type"]), tmp_lst["coordinates"]);}
 
-        else {
+      else {
 
-          feature_OBJ["properties"] = typeof_item(tmp_prop);              // recursive function
-        }
+        inner_geometry(writer, tmp_lst_nams[0], tmp_lst[0]);               // the first geometry-object of the list
       }
+    }
 
-      else {
+    if (idx_id != -1) {
 
-        Rcpp::stop("invalid member of the Feature geometry object --> inner_Feature() function");
+      SEXP tmp_id = geometry_objects[idx_id];
+
+      if ((TYPEOF(tmp_id) != STRSXP && TYPEOF(tmp_id) != REALSXP) || Rf_xlength(tmp_id) == 0) {
+
+        Rcpp::stop("the 'id' member should be either a character string or a numeric value --> inner_Feature() function");
       }
+
+      member(writer, "id", first);
+
+      writer.put_atomic_item(tmp_id, 0);
     }
 
-    return feature_OBJ;
+    if (idx_properties != -1) {
+
+      member(writer, "properties", first);
+
+      typeof_item(writer, geometry_objects[idx_properties]);             // recursive function
+    }
+
+    member(writer, "type", first);
+
+    writer.put_string(Feature_name);
+
+    writer.put('}');
   }
 
 
@@ -375,13 +530,13 @@ public:
 
     if (stringify) {
 
-      json11::Json::object feature_OBJ = inner_Feature(geometry_object_names, geometry_objects, tmp_nam);
+      GeoJson_Writer writer;
 
-      json11::Json res_json = feature_OBJ;
+      writer.reserve(estimate_json_size(geometry_objects));
 
-      std::string json_str = res_json.dump();
+      inner_Feature(writer, geometry_object_names, geometry_objects, tmp_nam);
 
-      RES["json_dump"] = json_str;
+      RES["json_dump"] = writer.str();
     }
 
     RES["type"] = tmp_nam;
@@ -390,10 +545,83 @@ public:
   }
 
 
-  // 'FeatureCollection' geometry object
+  // 'FeatureCollection' object [ the features are written one by one, thus the size of the buffer is bounded if the output is streamed to a file ]
   //
 
-  Rcpp::List feature_collection(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify = false) {
+  void inner_feature_collection(GeoJson_Writer &writer, std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects) {
+
+    int idx_bbox = -1, idx_features = -1;
+
+    for (unsigned int i = 0; i < geometry_object_names.size(); i++) {
+
+      if (geometry_object_names[i] == "bbox") {
+
+        idx_bbox = i;}
+
+      else if (geometry_object_names[i] == "features") {
+
+        idx_features = i;}
+
+      else {
+
+        Rcpp::stop("invalid object for the member 'features' of the 'FeatureCollection' object --> feature_collection() function");
+      }
+    }
+
+    bool first = true;
+
+    writer.put('{');
+
+    if (idx_bbox != -1) {
+
+      member(writer, "bbox", first);
+
+      writer.put_coordinates(geometry_objects[idx_bbox]);
+    }
+
+    if (idx_features != -1) {
+
+      member(writer, "features", first);
+
+      Rcpp::List tmp_feat = geometry_objects[idx_features];
+
+      std::vector<std::string> outer_lst_nams(tmp_feat.size(), "Feature");
+
+      if (tmp_feat.size() > 0 && !Rf_isNull(tmp_feat.attr("names"))) {
+
+        outer_lst_nams = Rcpp::as<std::vector<std::string> >(tmp_feat.attr("names"));
+      }
+
+      writer.put('[');
+
+      for (unsigned int j = 0; j < outer_lst_nams.size(); j++) {
+
+        if (j > 0) writer.sep();
+
+        Rcpp::List inner_feat_lst = tmp_feat[j];
+
+        std::vector<std::string> inner_lst_nams = inner_feat_lst.attr("names");
+
+        inner_Feature(writer, inner_lst_nams, inner_feat_lst, outer_lst_nams[j]);
+
+        writer.maybe_flush();
+      }
+
+      writer.put(']');
+    }
+
+    member(writer, "type", first);
+
+    writer.put_string("FeatureCollection");
+
+    writer.put('}');
+  }
+
+
+  // 'FeatureCollection' geometry object [ if 'path_to_file' is not an empty string then the json-dump is streamed to the file and it's not returned ]
+  //
+
+  Rcpp::List feature_collection(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify = false, std::string path_to_file = "") {
 
     Rcpp::List RES = geometry_objects;
 
@@ -403,67 +631,277 @@ public:
 
     if (stringify) {
 
-      json11::Json::object feature_col_OBJ;
+      GeoJson_Writer writer;
+
+      if (path_to_file != "") {
+
+        if (!writer.open(path_to_file)) {
 
-      feature_col_OBJ["type"] = feat_col_nam;
+          Rcpp::stop("the file '" + path_to_file + "' can not be opened for writing!");
+        }
 
-      for (unsigned int i = 0; i < geometry_object_names.size(); i++) {
+        inner_feature_collection(writer, geometry_object_names, geometry_objects);
 
-        if (geometry_object_names[i] == "bbox") {
+        writer.close();
+      }
 
-          std::vector<double> bbox_vec = geometry_objects["bbox"];
+      else {
 
-          feature_col_OBJ["bbox"] = json11::Json(bbox_vec);}
+        writer.reserve(estimate_json_size(geometry_objects));
 
-        else if (geometry_object_names[i] == "features") {
+        inner_feature_collection(writer, geometry_object_names, geometry_objects);
 
-          json11::Json::array multiple_features_OBJ;                                // initialize second json-object for multiple-feature-objects;
+        RES["json_dump"] = writer.str();
+      }
+    }
+
+    return RES;
+  }
+
+};
 
-          Rcpp::List tmp_feat = geometry_objects[i];
 
-          if (tmp_feat.size() == 0) {
 
-            feature_col_OBJ["features"] = json11::Json(multiple_features_OBJ);}      // empty object if Rcpp::List is empty
 
-          else {
+// updates the bounding box ( xmin, ymin, xmax, ymax ) using the coordinates of a geometry ( numeric vectors, matrices or nested lists of them )
+//
 
-            std::vector<std::string> outer_lst_nams = tmp_feat.attr("names");
+void coordinates_bbox(SEXP data, double *bbox) {
 
-            for (unsigned int j = 0; j < outer_lst_nams.size(); j++) {
+  int type = TYPEOF(data);
 
-              Rcpp::List inner_feat_lst = tmp_feat[j];
+  if (type == VECSXP) {
 
-              std::vector<std::string> inner_lst_nams = inner_feat_lst.attr("names");
+    for (R_xlen_t i = 0; i < Rf_xlength(data); i++) coordinates_bbox(VECTOR_ELT(data, i), bbox);
+  }
 
-              std::string tmp_inner_nam = outer_lst_nams[j];
+  else if (type == REALSXP || type == INTSXP) {
 
-              json11::Json::object inner_loop_json11 = inner_Feature(inner_lst_nams, inner_feat_lst, tmp_inner_nam);
+    bool is_matrix = Rf_isMatrix(data);
 
-              multiple_features_OBJ.push_back(inner_loop_json11);
-            }
-          }
+    R_xlen_t nrow = is_matrix ? Rf_nrows(data) : 1;
 
-          feature_col_OBJ["features"] = multiple_features_OBJ;
-        }
+    if ((is_matrix ? Rf_ncols(data) : Rf_xlength(data)) < 2) return;
 
-        else {
+    const double *real_data = (type == REALSXP) ? real_ro(data) : NULL;
 
-          Rcpp::stop("invalid object for the member 'features' of the 'FeatureCollection' object --> feature_collection() function");
+    const int *int_data = (type == REALSXP) ? NULL : integer_ro(data);
+
+    for (R_xlen_t i = 0; i < nrow; i++) {
+
+      if (int_data != NULL && (int_data[i] == NA_INTEGER || int_data[i + nrow] == NA_INTEGER)) continue;
+
+      double x = real_data != NULL ? real_data[i] : int_data[i];
+
+      double y = real_data != NULL ? real_data[i + nrow] : int_data[i + nrow];
+
+      bbox[0] = std::min(bbox[0], x);
+
+      bbox[1] = std::min(bbox[1], y);
+
+      bbox[2] = std::max(bbox[2], x);
+
+      bbox[3] = std::max(bbox[3], y);
+    }
+  }
+}
+
+
+// Class to write a FeatureCollection to a file incrementally ( the Features are appended in chunks ). The "bbox" is optionally updated with the coordinates
+// of the appended Features and it is written at the end to a placeholder ( of white-space ) which is reserved when the file is opened
+//
+
+class FeatureCollection_Writer {
+
+private:
+
+  GeoJson_Writer writer;
+
+  GeoJson_Writer feat_writer;                                                         // a single Feature, which is added to the 'writer' only if it was written without an error
+
+  GeoJson_Collections gjc;
+
+  std::string path_to_file;
+
+  int num_features;
+
+  bool update_bbox;
+
+  double bbox[4];
+
+  long bbox_offset;                                                                   // position of the placeholder of the "bbox" in the file
+
+  int writer_precision;
+
+  static const int bbox_width = 112;                                                  // 4 doubles of at most 24 characters and the separators
+
+
+  // the "bbox" json-array padded with white-space to the width of the placeholder
+  //
+
+  std::string bbox_array() {
+
+    GeoJson_Writer tmp(writer_precision);
+
+    tmp.put('[');
+
+    if (bbox[0] <= bbox[2]) {
+
+      for (int j = 0; j < 4; j++) {
+
+        if (j > 0) tmp.sep();
+
+        tmp.put_double(bbox[j]);
+      }
+    }
+
+    tmp.put(']');
+
+    std::string res = tmp.str();
+
+    if (res.size() < static_cast<size_t>(bbox_width)) res.append(bbox_width - res.size(), ' ');
+
+    return res;
+  }
+
+public:
+
+  FeatureCollection_Writer(std::string path, std::vector<double> bbox_vec, bool update, int precision) : writer(precision), feat_writer(precision), path_to_file(path), num_features(0),
+
+                           update_bbox(update), bbox_offset(-1), writer_precision(precision) {
+
+    if (!bbox_vec.empty() && bbox_vec.size() != 4 && update_bbox) Rcpp::stop("the 'bbox' should be of length 4 ( xmin, ymin, xmax, ymax ) if it's updated!");
+
+    if (update_bbox && is_gzip_path(path_to_file)) Rcpp::stop("the 'bbox' can not be updated in a gzip-compressed file!");
+
+    if (!writer.open(path_to_file)) Rcpp::stop("the file '" + path_to_file + "' can not be opened for writing!");
+
+    bbox[0] = bbox[1] = std::numeric_limits<double>::infinity();
+
+    bbox[2] = bbox[3] = -std::numeric_limits<double>::infinity();
+
+    writer.put('{');
+
+    if (update_bbox) {
+
+      if (!bbox_vec.empty()) std::copy(bbox_vec.begin(), bbox_vec.end(), bbox);
+
+      writer.key("bbox");
+
+      bbox_offset = writer.file_position();
+
+      writer.put(bbox_array());
+
+      writer.sep();}
+
+    else if (!bbox_vec.empty()) {
+
+      writer.key("bbox");
+
+      writer.put('[');
+
+      for (size_t j = 0; j < bbox_vec.size(); j++) {
+
+        if (j > 0) writer.sep();
+
+        writer.put_double(bbox_vec[j]);
+      }
+
+      writer.put(']');
+
+      writer.sep();
+    }
+
+    writer.key("features");
+
+    writer.put('[');
+  }
+
+
+  // appends a list of Features ( in the format of the 'TO_GeoJson' or the 'FROM_GeoJson' output ). Each Feature is first written to a separate buffer, thus
+  // an invalid Feature raises an error without modifying the output ( the previous Features of the list are kept )
+  //
+
+  int append(Rcpp::List features) {
+
+    for (int i = 0; i < features.size(); i++) {
+
+      SEXP tmp_feat = features[i];
+
+      if (TYPEOF(tmp_feat) != VECSXP || Rf_isNull(Rf_getAttrib(tmp_feat, R_NamesSymbol))) {
+
+        Rcpp::stop("each Feature should be a named list ( Feature " + std::to_string(i + 1) + " )");
+      }
+
+      Rcpp::List inner_feat_lst(tmp_feat);
+
+      std::vector<std::string> inner_lst_nams = inner_feat_lst.attr("names");
+
+      feat_writer.str().clear();
+
+      gjc.inner_Feature(feat_writer, inner_lst_nams, inner_feat_lst, "Feature");
+
+      double feat_bbox[4] = {bbox[0], bbox[1], bbox[2], bbox[3]};
+
+      if (update_bbox && inner_feat_lst.containsElementNamed("geometry")) {
+
+        Rcpp::List tmp_geom = inner_feat_lst["geometry"];
+
+        if (tmp_geom.containsElementNamed("coordinates")) {
+
+          coordinates_bbox(tmp_geom["coordinates"], feat_bbox);}
+
+        else if (tmp_geom.size() > 0) {
+
+          coordinates_bbox(tmp_geom[0], feat_bbox);
         }
       }
 
-      json11::Json inner_res_json = feature_col_OBJ;
+      if (num_features > 0) writer.sep();
 
-      std::string json_str = inner_res_json.dump();
+      writer.put(feat_writer.str());
 
-      RES["json_dump"] = json_str;
+      std::copy(feat_bbox, feat_bbox + 4, bbox);
+
+      num_features++;
+
+      writer.maybe_flush();
     }
 
-    return RES;
+    return features.size();
   }
 
-};
 
+  // writes the updated "bbox" and the end of the FeatureCollection [ the "bbox" is checked first, thus a failed 'close()' can be repeated ]
+  //
+
+  int close() {
+
+    std::string bbox_str = update_bbox ? bbox_array() : "";
+
+    if (bbox_str.size() > static_cast<size_t>(bbox_width)) {
+
+      Rcpp::stop("the 'bbox' exceeds the reserved space of the file '" + path_to_file + "' ( decrease the 'digits' )!");
+    }
+
+    if (update_bbox && !writer.patch(bbox_offset, bbox_str)) {
+
+      Rcpp::stop("the 'bbox' could not be written to the file '" + path_to_file + "'!");
+    }
+
+    writer.put("], ");
+
+    writer.key("type");
+
+    writer.put("\"FeatureCollection\"}");
+
+    writer.close();
+
+    return num_features;
+  }
+
+  ~FeatureCollection_Writer() { }
+};
 
 
 
@@ -479,31 +917,31 @@ public:
 // [[Rcpp::export]]
 Rcpp::List export_To_GeoJson(std::string geometry_object, std::vector<double> data_POINTS, std::vector<std::vector<double>> data_ARRAYS, std::vector<std::vector<std::vector<double>>> data_ARRAY_ARRAYS,
 
-                             std::vector<std::vector<std::vector<std::vector<double>>>> data_POLYGON_ARRAYS, bool stringify = false) {
+                             std::vector<std::vector<std::vector<std::vector<double>>>> data_POLYGON_ARRAYS, bool stringify = false, double simplify_tolerance = 0.0) {
 
 
   if (geometry_object == "Point") {
 
-    GeoJson_Geometries<std::vector<double>> tgj;
+    GeoJson_Geometries<std::vector<double>> tgj(simplify_tolerance);
 
     return tgj.To_Geom_Obj(geometry_object, data_POINTS, stringify);
   }
 
   else if (geometry_object == "MultiPoint" || geometry_object == "LineString") {
 
-    GeoJson_Geometries<std::vector<std::vector<double>>> tgj;
+    GeoJson_Geometries<std::vector<std::vector<double>>> tgj(simplify_tolerance);
 
     return tgj.To_Geom_Obj(geometry_object, data_ARRAYS, stringify);}
 
   else if (geometry_object == "MultiLineString" || geometry_object == "Polygon") {
 
-    GeoJson_Geometries<std::vector<std::vector<std::vector<double>>>> tgj;
+    GeoJson_Geometries<std::vector<std::vector<std::vector<double>>>> tgj(simplify_tolerance);
 
     return tgj.To_Geom_Obj(geometry_object, data_ARRAY_ARRAYS, stringify);}
 
   else if (geometry_object == "MultiPolygon") {
 
-    GeoJson_Geometries<std::vector<std::vector<std::vector<std::vector<double>>>>> tgj;
+    GeoJson_Geometries<std::vector<std::vector<std::vector<std::vector<double>>>>> tgj(simplify_tolerance);
 
     return tgj.To_Geom_Obj(geometry_object, data_POLYGON_ARRAYS, stringify);}
 
@@ -515,6 +953,68 @@ Rcpp::List export_To_GeoJson(std::string geometry_object, std::vector<double> da
 
 
 
+// geometry-object from numeric matrices ( one position per row ) : a matrix for the 'MultiPoint' and 'LineString', a list of matrices for the 'MultiLineString'
+// and 'Polygon' and a list of lists of matrices for the 'MultiPolygon'. The positions are read from the R matrices ( 'Matrix_View' ) without conversion to
+// nested std::vectors
+//
+
+Matrix_View matrix_view(SEXP data) {
+
+  if (TYPEOF(data) != REALSXP || !Rf_isMatrix(data)) Rcpp::stop("the coordinates should be numeric matrices ( one position per row ) --> export_To_GeoJson_matrix() function");
+
+  if (Rf_ncols(data) < 2 || Rf_ncols(data) > 3) Rcpp::stop("the numeric matrices should have 2 or 3 columns ( longitude, latitude and optionally altitude ) --> export_To_GeoJson_matrix() function");
+
+  return Matrix_View(data);
+}
+
+
+std::vector<Matrix_View> matrix_views(SEXP data) {
+
+  if (TYPEOF(data) != VECSXP) Rcpp::stop("the coordinates should be a list of numeric matrices --> export_To_GeoJson_matrix() function");
+
+  std::vector<Matrix_View> res(Rf_xlength(data));
+
+  for (size_t i = 0; i < res.size(); i++) res[i] = matrix_view(VECTOR_ELT(data, i));
+
+  return res;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List export_To_GeoJson_matrix(std::string geometry_object, SEXP data, bool stringify = false, double simplify_tolerance = 0.0) {
+
+  if (geometry_object == "MultiPoint" || geometry_object == "LineString") {
+
+    GeoJson_Geometries<Matrix_View> tgj(simplify_tolerance);
+
+    return tgj.To_Geom_Obj(geometry_object, matrix_view(data), stringify);}
+
+  else if (geometry_object == "MultiLineString" || geometry_object == "Polygon") {
+
+    GeoJson_Geometries<std::vector<Matrix_View>> tgj(simplify_tolerance);
+
+    return tgj.To_Geom_Obj(geometry_object, matrix_views(data), stringify);}
+
+  else if (geometry_object == "MultiPolygon") {
+
+    if (TYPEOF(data) != VECSXP) Rcpp::stop("the coordinates should be a list of lists of numeric matrices --> export_To_GeoJson_matrix() function");
+
+    std::vector<std::vector<Matrix_View>> polygons(Rf_xlength(data));
+
+    for (size_t i = 0; i < polygons.size(); i++) polygons[i] = matrix_views(VECTOR_ELT(data, i));
+
+    GeoJson_Geometries<std::vector<std::vector<Matrix_View>>> tgj(simplify_tolerance);
+
+    return tgj.To_Geom_Obj(geometry_object, polygons, stringify);}
+
+  else {
+
+    Rcpp::stop("invalid geometry object --> export_To_GeoJson_matrix() function");
+  }
+}
+
+
+
 // Geometry-collection object
 //
 
@@ -545,11 +1045,109 @@ Rcpp::List Feature_Obj(std::vector<std::string> geometry_object_names, Rcpp::Lis
 //
 
 // [[Rcpp::export]]
-Rcpp::List Feature_collection_Obj(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify = false) {
+Rcpp::List Feature_collection_Obj(std::vector<std::string> geometry_object_names, Rcpp::List geometry_objects, bool stringify = false, std::string path_to_file = "") {
 
   GeoJson_Collections gjc_feature_collection;
 
-  return gjc_feature_collection.feature_collection(geometry_object_names, geometry_objects, stringify);
+  return gjc_feature_collection.feature_collection(geometry_object_names, geometry_objects, stringify, path_to_file);
+}
+
+
+
+// GeoJSON text sequence ( RFC 8142 ) or newline-delimited json of a list of Features [ one Feature per line ]. If 'append' is TRUE then the Features are
+// appended to an existing file, thus the Features can be written in chunks. The output is buffered and written to the file whenever the buffer exceeds
+// 'buffer_size' bytes. It returns the number of Features written
+//
+
+// [[Rcpp::export]]
+int export_GeoJson_Seq(Rcpp::List features, std::string path_to_file, bool append = false, bool rs_separator = false, int precision = -1, double buffer_size = 4194304) {
+
+  GeoJson_Collections gjc_seq;
+
+  GeoJson_Writer writer(precision);
+
+  if (!writer.open(path_to_file, append, static_cast<size_t>(buffer_size))) {
+
+    Rcpp::stop("the file '" + path_to_file + "' can not be opened for writing!");
+  }
+
+  int num_feat = features.size();
+
+  for (int i = 0; i < num_feat; i++) {
+
+    SEXP tmp_feat = features[i];
+
+    if (TYPEOF(tmp_feat) != VECSXP || Rf_isNull(Rf_getAttrib(tmp_feat, R_NamesSymbol))) {
+
+      Rcpp::stop("each Feature should be a named list ( Feature " + std::to_string(i + 1) + " )");
+    }
+
+    Rcpp::List inner_feat_lst(tmp_feat);
+
+    std::vector<std::string> inner_lst_nams = inner_feat_lst.attr("names");
+
+    if (rs_separator) writer.put('\x1e');                                      // record separator
+
+    gjc_seq.inner_Feature(writer, inner_lst_nams, inner_feat_lst, "Feature");
+
+    writer.put('\n');
+
+    writer.maybe_flush();
+  }
+
+  writer.close();
+
+  return num_feat;
+}
+
+
+
+// incremental FeatureCollection file-writer : the handle is an external pointer, which is released when the FeatureCollection is closed
+//
+
+FeatureCollection_Writer *get_FC_Writer(SEXP handle) {
+
+  Rcpp::XPtr<FeatureCollection_Writer> ptr(handle);
+
+  FeatureCollection_Writer *fcw = ptr.get();
+
+  if (fcw == NULL) {
+
+    Rcpp::stop("the FeatureCollection writer is not valid ( it was either closed or restored from a previous R session )!");
+  }
+
+  return fcw;
+}
+
+
+// [[Rcpp::export]]
+SEXP export_fc_writer_open(std::string path_to_file, std::vector<double> bbox_vec, bool update_bbox = false, int precision = -1) {
+
+  Rcpp::XPtr<FeatureCollection_Writer> ptr(new FeatureCollection_Writer(path_to_file, bbox_vec, update_bbox, precision), true);
+
+  return ptr;
 }
 
 
+// [[Rcpp::export]]
+int export_fc_writer_append(SEXP handle, Rcpp::List features) {
+
+  FeatureCollection_Writer *fcw = get_FC_Writer(handle);
+
+  return fcw->append(features);
+}
+
+
+// [[Rcpp::export]]
+int export_fc_writer_close(SEXP handle) {
+
+  FeatureCollection_Writer *fcw = get_FC_Writer(handle);
+
+  int num_features = fcw->close();
+
+  delete fcw;
+
+  R_ClearExternalPtr(handle);
+
+  return num_features;
+}
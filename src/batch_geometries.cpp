@@ -0,0 +1,207 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file batch_geometries.cpp
+ *
+ * @Notes: builds many geometries of the same type from a long-format table of coordinates ( one position per row and the feature, part and ring id's ).
+ *         The rows are grouped in a single pass into the ragged-offset layout ( a coordinate matrix and nested 0-based offsets ), which is either converted
+ *         to the R lists of the geometries or written as a FeatureCollection [ see the 'dataframe_export.cpp' file ]
+ *
+ **/
+
+
+# include <RcppArmadillo.h>
+// [[Rcpp::depends("RcppArmadillo")]]
+// [[Rcpp::plugins(cpp11)]]
+
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "geojson_writer.h"
+
+
+
+//========================
+// Rcpp-exported functions
+//========================
+
+
+// offsets of the ragged-offset layout from the group-codes of the rows. The 'group_codes' list includes a (1-based) integer vector for each level of
+// the geometry ( feature, part, ring ). A new group of a level starts at a row where the code of this or of an outer level changes. The codes of the features
+// are the order of first appearance ( 'match(x, unique(x))' ), therefore a code which is not greater than the previous ones means that the rows of a
+// feature are not consecutive
+//
+
+// [[Rcpp::export]]
+Rcpp::List long_format_offsets(Rcpp::List group_codes) {
+
+  int num_levels = group_codes.size();
+
+  std::vector<const int *> codes(num_levels);
+
+  R_xlen_t num_rows = 0;
+
+  for (int l = 0; l < num_levels; l++) {
+
+    SEXP tmp_codes = group_codes[l];
+
+    if (TYPEOF(tmp_codes) != INTSXP) Rcpp::stop("the group codes should be integer vectors --> long_format_offsets() function");
+
+    if (l > 0 && Rf_xlength(tmp_codes) != num_rows) Rcpp::stop("the id columns should have the same length as the coordinates");
+
+    num_rows = Rf_xlength(tmp_codes);
+
+    codes[l] = INTEGER(tmp_codes);
+  }
+
+  std::vector<std::vector<int> > offsets(num_levels);
+
+  std::vector<int> num_groups(num_levels, 0);
+
+  int max_feature = 0;
+
+  for (R_xlen_t i = 0; i < num_rows; i++) {
+
+    int first_new = num_levels;                                         // outermost level where a new group starts
+
+    for (int l = 0; l < num_levels; l++) {
+
+      if (i == 0 || codes[l][i] != codes[l][i - 1]) {
+
+        first_new = l;
+
+        break;
+      }
+    }
+
+    if (first_new == 0) {
+
+      if (codes[0][i] <= max_feature) Rcpp::stop("the rows of each feature should be consecutive ( row " + std::to_string(i + 1) + " )");
+
+      max_feature = codes[0][i];
+    }
+
+    for (int l = first_new; l < num_levels; l++) {                      // a new group of a level starts a new group in all inner levels
+
+      offsets[l].push_back((l + 1 < num_levels) ? num_groups[l + 1] : static_cast<int>(i));
+
+      num_groups[l]++;
+    }
+  }
+
+  Rcpp::List res(num_levels);
+
+  for (int l = 0; l < num_levels; l++) {
+
+    offsets[l].push_back((l + 1 < num_levels) ? num_groups[l + 1] : static_cast<int>(num_rows));
+
+    res[l] = Rcpp::wrap(offsets[l]);
+  }
+
+  return res;
+}
+
+
+// coordinates of the item 'idx' of the offsets-level 'level' [ the offsets are validated in the 'ragged_geometries_list()' function ]
+//
+
+SEXP ragged_coordinates(const Rcpp::NumericMatrix &coords, const std::vector<const int *> &offsets, size_t level, int idx) {
+
+  int start = offsets[level][idx], end = offsets[level][idx + 1];
+
+  if (level + 1 == offsets.size()) {
+
+    int nrow = coords.nrow(), ncol = coords.ncol();
+
+    Rcpp::NumericMatrix res(end - start, ncol);
+
+    for (int j = 0; j < ncol; j++) {
+
+      std::memcpy(REAL(res) + static_cast<R_xlen_t>(j) * (end - start), REAL(coords) + static_cast<R_xlen_t>(j) * nrow + start, sizeof(double) * (end - start));
+    }
+
+    return res;
+  }
+
+  Rcpp::List res(end - start);
+
+  for (int k = start; k < end; k++) {
+
+    res[k - start] = ragged_coordinates(coords, offsets, level + 1, k);
+  }
+
+  return res;
+}
+
+
+// R lists of the geometries ( 'type' and 'coordinates' ) of the ragged-offset layout. The coordinates are numeric vectors ( 'Point' ), numeric matrices
+// ( 'MultiPoint', 'LineString' ), lists of matrices ( 'MultiLineString', 'Polygon' ) or lists of lists of matrices ( 'MultiPolygon' ), which are copied
+// column by column from the coordinate matrix
+//
+
+// [[Rcpp::export]]
+Rcpp::List ragged_geometries_list(std::string geometry_type, Rcpp::NumericMatrix coords, Rcpp::List offsets) {
+
+  int depth = geometry_type_depth(geometry_type);
+
+  if (depth == 0) Rcpp::stop("invalid geometry-type '" + geometry_type + "' ( valid types : 'Point', 'MultiPoint', 'LineString', 'MultiLineString', 'Polygon', 'MultiPolygon' )");
+
+  if (offsets.size() != depth - 1) Rcpp::stop("the geometry-type '" + geometry_type + "' requires " + std::to_string(depth - 1) + " vector(s) of offsets!");
+
+  std::vector<const int *> tmp_offsets(offsets.size());
+
+  for (int l = 0; l < offsets.size(); l++) {
+
+    SEXP tmp_lev = offsets[l];
+
+    if (TYPEOF(tmp_lev) != INTSXP || Rf_xlength(tmp_lev) < 1) Rcpp::stop("the offsets should be non-empty integer vectors!");
+
+    tmp_offsets[l] = INTEGER(tmp_lev);
+  }
+
+  for (int l = 0; l < offsets.size(); l++) {                                    // the offsets are validated once, so that the coordinates are copied without bounds-checks
+
+    R_xlen_t size_lev = Rf_xlength(offsets[l]);
+
+    R_xlen_t next_size = (l + 1 == offsets.size()) ? coords.nrow() : Rf_xlength(offsets[l + 1]) - 1;
+
+    for (R_xlen_t k = 0; k < size_lev; k++) {
+
+      bool invalid = tmp_offsets[l][k] == NA_INTEGER || tmp_offsets[l][k] < 0 || tmp_offsets[l][k] > next_size || (k > 0 && tmp_offsets[l][k] < tmp_offsets[l][k - 1]);
+
+      if (invalid) Rcpp::stop("the offsets of level " + std::to_string(l + 1) + " should be non-decreasing 0-based indices of the next level!");
+    }
+  }
+
+  int num_features = (depth == 1) ? coords.nrow() : Rf_xlength(offsets[0]) - 1;
+
+  Rcpp::CharacterVector type_str = Rcpp::CharacterVector::create(geometry_type);
+
+  Rcpp::List res(num_features);
+
+  for (int i = 0; i < num_features; i++) {
+
+    Rcpp::RObject tmp_coords;
+
+    if (depth == 1) {
+
+      Rcpp::NumericVector point(coords.ncol());
+
+      for (int j = 0; j < coords.ncol(); j++) point[j] = coords(i, j);
+
+      tmp_coords = point;}
+
+    else {
+
+      tmp_coords = ragged_coordinates(coords, tmp_offsets, 0, i);
+    }
+
+    res[i] = Rcpp::List::create(Rcpp::Named("type") = type_str, Rcpp::Named("coordinates") = tmp_coords);
+  }
+
+  return res;
+}
+
@@ -0,0 +1,513 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file dataframe_export.cpp
+ *
+ * @Notes: writes the rows of a data.frame ( properties ) and a geometry column as the Features of a FeatureCollection. The geometry column is either a list
+ *         ( one item per feature ) or a ragged-offset layout ( a coordinate matrix and nested 0-based offsets, as in the GeoArrow specification )
+ *
+ **/
+
+
+# include <RcppArmadillo.h>
+// [[Rcpp::depends("RcppArmadillo")]]
+// [[Rcpp::plugins(cpp11)]]
+
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "geojson_writer.h"
+#include "profiler.h"
+
+
+
+// Class for the Features of a data.frame
+//
+// the type of each column is resolved once ( 'Property_Column' ), thus the rows are written without the per-value 'TYPEOF()' dispatch of the recursive
+// 'typeof_item()' function. The keys and the factor levels are escaped once as well
+//
+
+class DataFrame_Features {
+
+private:
+
+  enum Column_Kind { REAL_COLUMN, INTEGER_COLUMN, LOGICAL_COLUMN, STRING_COLUMN, FACTOR_COLUMN };
+
+  struct Property_Column {
+
+    std::string name;                                 // the column name ( the sort key )
+
+    std::string key;                                  // escaped key including the separator ( "name": )
+
+    Column_Kind kind;
+
+    SEXP data;
+
+    std::vector<std::string> levels;                  // escaped levels of a factor
+  };
+
+  std::vector<Property_Column> columns;               // sorted by the raw name and without duplicate names ( the last column is kept ), which are the keys of a json11 object
+
+  std::vector<Property_Column> id_column;             // empty if the Features do not have an 'id'
+
+  std::vector<std::string> geometry_types;            // escaped geometry-type of each feature ( or a single one for all features )
+
+  std::vector<int> geometry_depth;                    // nesting level of the coordinates ( 'Point' : 1, ..., 'MultiPolygon' : 4 )
+
+  SEXP geometry_list;                                 // list-layout ( R_NilValue for the ragged-offset layout )
+
+  const double *coords;                               // ragged-offset layout ( column-major coordinate matrix )
+
+  Rcpp::RObject coords_real;                          // the coordinate matrix coerced to double ( if it's an integer matrix )
+
+  int coords_nrow, coords_ncol;
+
+  std::vector<const int *> offsets;
+
+  std::vector<R_xlen_t> offsets_length;
+
+  R_xlen_t num_features;
+
+
+  // escaped string of a std::string
+  //
+
+  std::string escaped(const std::string &value) {
+
+    GeoJson_Writer tmp;
+
+    tmp.put_string(value);
+
+    return tmp.str();
+  }
+
+
+  // the type of a column is resolved once
+  //
+
+  Property_Column property_column(const std::string &name, SEXP data) {
+
+    Property_Column col;
+
+    col.name = name;
+
+    col.key = escaped(name) + ": ";
+
+    col.data = data;
+
+    if (Rf_xlength(data) != num_features) {
+
+      Rcpp::stop("the column '" + name + "' of the data.frame should have as many rows as the number of geometries!");
+    }
+
+    switch (TYPEOF(data)) {
+
+      case REALSXP: col.kind = REAL_COLUMN; break;
+
+      case LGLSXP: col.kind = LOGICAL_COLUMN; break;
+
+      case STRSXP: col.kind = STRING_COLUMN; break;
+
+      case INTSXP: {
+
+        if (Rf_isFactor(data)) {
+
+          col.kind = FACTOR_COLUMN;
+
+          SEXP levels = Rf_getAttrib(data, R_LevelsSymbol);
+
+          for (R_xlen_t i = 0; i < Rf_xlength(levels); i++) {
+
+            col.levels.push_back(escaped(CHAR(STRING_ELT(levels, i))));
+          }
+
+          const int *codes = integer_ro(data);                                  // the codes are validated once, so that the levels are accessed without bounds-checks
+
+          int num_levels = col.levels.size();
+
+          for (R_xlen_t i = 0; i < num_features; i++) {
+
+            if (codes[i] != NA_INTEGER && (codes[i] < 1 || codes[i] > num_levels)) {
+
+              Rcpp::stop("the factor column '" + name + "' of the data.frame includes codes which do not correspond to a level!");
+            }
+          }
+        }
+
+        else {
+
+          col.kind = INTEGER_COLUMN;
+        }
+
+        break;
+      }
+
+      default: Rcpp::stop("the column '" + name + "' of the data.frame should be of type numeric, integer, factor, logical or character!");
+    }
+
+    return col;
+  }
+
+
+  // value of a column at a row ( NA : null )
+  //
+
+  void put_value(GeoJson_Writer &writer, const Property_Column &col, R_xlen_t row) {
+
+    switch (col.kind) {
+
+      case REAL_COLUMN: writer.put_double(REAL(col.data)[row]); break;
+
+      case INTEGER_COLUMN: writer.put_int(INTEGER(col.data)[row]); break;
+
+      case LOGICAL_COLUMN: writer.put_bool(LOGICAL(col.data)[row]); break;
+
+      case STRING_COLUMN: writer.put_string(STRING_ELT(col.data, row)); break;
+
+      case FACTOR_COLUMN: {
+
+        int level = INTEGER(col.data)[row];
+
+        if (level == NA_INTEGER) {
+
+          writer.put_null();}
+
+        else {
+
+          writer.put(col.levels[level - 1]);
+        }
+
+        break;
+      }
+    }
+  }
+
+
+  // position of the coordinate matrix ( ragged-offset layout )
+  //
+
+  void put_position(GeoJson_Writer &writer, R_xlen_t row) {
+
+    writer.put('[');
+
+    for (int j = 0; j < coords_ncol; j++) {
+
+      if (j > 0) writer.sep();
+
+      writer.put_double(coords[row + static_cast<R_xlen_t>(j) * coords_nrow]);
+    }
+
+    writer.put(']');
+  }
+
+
+  // coordinates of the item 'idx' of the offsets-level 'level' ( ragged-offset layout )
+  //
+
+  void put_offsets(GeoJson_Writer &writer, size_t level, R_xlen_t idx) {
+
+    int start = offsets[level][idx], end = offsets[level][idx + 1];
+
+    writer.put('[');
+
+    for (int k = start; k < end; k++) {
+
+      if (k > start) writer.sep();
+
+      if (level + 1 == offsets.size()) {
+
+        put_position(writer, k);}
+
+      else {
+
+        put_offsets(writer, level + 1, k);
+      }
+    }
+
+    writer.put(']');
+  }
+
+
+  void put_geometry(GeoJson_Writer &writer, R_xlen_t row) {
+
+    size_t t = (geometry_types.size() == 1) ? 0 : row;
+
+    if (geometry_list != R_NilValue) {
+
+      SEXP item = VECTOR_ELT(geometry_list, row);
+
+      if (Rf_isNull(item)) {
+
+        writer.put_null();
+
+        return;
+      }
+
+      writer.put("{\"coordinates\": ");
+
+      writer.put_coordinates(item, geometry_depth[t]);                 // a matrix of a 'Polygon' is a single ring etc.
+    }
+
+    else {
+
+      writer.put("{\"coordinates\": ");
+
+      if (offsets.empty()) {
+
+        put_position(writer, row);}                                    // 'Point'
+
+      else {
+
+        put_offsets(writer, 0, row);
+      }
+    }
+
+    writer.put(", \"type\": ");
+
+    writer.put(geometry_types[t]);
+
+    writer.put('}');
+  }
+
+
+public:
+
+  DataFrame_Features(Rcpp::List data, Rcpp::List geometry, std::vector<std::string> geometry_type, bool ragged, int id_idx) : geometry_list(R_NilValue),
+
+                     coords(NULL), coords_nrow(0), coords_ncol(0), num_features(0) {
+
+    if (geometry_type.empty()) Rcpp::stop("the 'geometry_type' parameter should be a non-empty character vector!");
+
+    for (unsigned int t = 0; t < geometry_type.size(); t++) {
+
+      geometry_depth.push_back(geometry_type_depth(geometry_type[t]));
+
+      if (geometry_depth.back() == 0) {
+
+        Rcpp::stop("invalid geometry-type '" + geometry_type[t] + "' ( valid types : 'Point', 'MultiPoint', 'LineString', 'MultiLineString', 'Polygon', 'MultiPolygon' )");
+      }
+
+      geometry_types.push_back(escaped(geometry_type[t]));
+    }
+
+    if (ragged) {
+
+      if (geometry_type.size() != 1) Rcpp::stop("the ragged-offset layout requires a single geometry-type!");
+
+      SEXP tmp_coords = geometry["coords"];                                  // not an Rcpp::NumericMatrix, which would copy an ALTREP ( 'Lazy_Coords' ) matrix to R memory
+
+      if (!Rf_isMatrix(tmp_coords) || (TYPEOF(tmp_coords) != REALSXP && TYPEOF(tmp_coords) != INTSXP)) Rcpp::stop("the 'coords' of the ragged-offset layout should be a numeric matrix!");
+
+      if (TYPEOF(tmp_coords) != REALSXP) {
+
+        coords_real = Rf_coerceVector(tmp_coords, REALSXP);
+
+        tmp_coords = coords_real;
+      }
+
+      coords = real_ro(tmp_coords);
+
+      coords_nrow = Rf_nrows(tmp_coords);
+
+      coords_ncol = Rf_ncols(tmp_coords);
+
+      Rcpp::List tmp_offsets = geometry["offsets"];
+
+      if (tmp_offsets.size() != geometry_depth[0] - 1) {
+
+        Rcpp::stop("the geometry-type '" + geometry_type[0] + "' requires " + std::to_string(geometry_depth[0] - 1) + " vector(s) of offsets!");
+      }
+
+      for (int l = 0; l < tmp_offsets.size(); l++) {
+
+        SEXP tmp_lev = tmp_offsets[l];
+
+        if (TYPEOF(tmp_lev) != INTSXP || Rf_xlength(tmp_lev) < 1) Rcpp::stop("the offsets should be non-empty integer vectors!");
+
+        offsets.push_back(INTEGER(tmp_lev));
+
+        offsets_length.push_back(Rf_xlength(tmp_lev));
+      }
+
+      for (size_t l = 0; l < offsets.size(); l++) {                   // the offsets are validated once, so that the coordinates are accessed without bounds-checks
+
+        R_xlen_t next_size = (l + 1 == offsets.size()) ? coords_nrow : offsets_length[l + 1] - 1;
+
+        for (R_xlen_t k = 0; k < offsets_length[l]; k++) {
+
+          bool invalid = offsets[l][k] == NA_INTEGER || offsets[l][k] < 0 || offsets[l][k] > next_size || (k > 0 && offsets[l][k] < offsets[l][k - 1]);
+
+          if (invalid) Rcpp::stop("the offsets of level " + std::to_string(l + 1) + " should be non-decreasing 0-based indices of the next level!");
+        }
+      }
+
+      num_features = offsets.empty() ? coords_nrow : offsets_length[0] - 1;
+    }
+
+    else {
+
+      geometry_list = geometry;
+
+      num_features = geometry.size();
+    }
+
+    if (geometry_types.size() != 1 && static_cast<R_xlen_t>(geometry_types.size()) != num_features) {
+
+      Rcpp::stop("the 'geometry_type' parameter should be either of length 1 or of length equal to the number of geometries!");
+    }
+
+    if (data.size() > 0) {
+
+      std::vector<std::string> nams = Rcpp::as<std::vector<std::string> >(data.names());
+
+      for (int c = 0; c < data.size(); c++) {
+
+        Property_Column col = property_column(nams[c], data[c]);
+
+        if (c == id_idx) {
+
+          if (col.kind != REAL_COLUMN && col.kind != INTEGER_COLUMN && col.kind != STRING_COLUMN && col.kind != FACTOR_COLUMN) {
+
+            Rcpp::stop("the 'id' column should be of type numeric, integer, factor or character!");
+          }
+
+          id_column.push_back(col);}
+
+        else {
+
+          columns.push_back(col);
+        }
+      }
+
+      std::stable_sort(columns.begin(), columns.end(), [](const Property_Column &a, const Property_Column &b) { return a.name < b.name; });
+
+      std::vector<Property_Column> unique_columns;                 // the same as 'sorted_members()' of 'TO_geojson.cpp'
+
+      for (size_t c = 0; c < columns.size(); c++) {
+
+        if (c + 1 < columns.size() && columns[c].name == columns[c + 1].name) continue;
+
+        unique_columns.push_back(columns[c]);
+      }
+
+      columns.swap(unique_columns);
+    }
+  }
+
+
+  // writes the FeatureCollection. The members of the Features are written in the order : "geometry", "id", "properties", "type"
+  //
+
+  void write(GeoJson_Writer &writer) {
+
+    writer.put("{\"features\": [");
+
+    for (R_xlen_t i = 0; i < num_features; i++) {
+
+      if (i > 0) writer.sep();
+
+      writer.put("{\"geometry\": ");
+
+      put_geometry(writer, i);
+
+      if (!id_column.empty()) {
+
+        writer.put(", \"id\": ");
+
+        put_value(writer, id_column[0], i);
+      }
+
+      writer.put(", \"properties\": {");
+
+      for (size_t c = 0; c < columns.size(); c++) {
+
+        if (c > 0) writer.sep();
+
+        writer.put(columns[c].key);
+
+        put_value(writer, columns[c], i);
+      }
+
+      writer.put("}, \"type\": \"Feature\"}");
+
+      writer.maybe_flush();
+    }
+
+    writer.put("], \"type\": \"FeatureCollection\"}");
+  }
+
+
+  // approximate size of the output
+  //
+
+  size_t estimate_size() {
+
+    size_t res = 64 + 48 * num_features;
+
+    for (size_t c = 0; c < columns.size(); c++) res += (columns[c].key.size() + 2) * num_features + estimate_json_size(columns[c].data);
+
+    res += (geometry_list != R_NilValue) ? estimate_json_size(geometry_list) : 24 * static_cast<size_t>(coords_nrow) * coords_ncol;
+
+    return res;
+  }
+
+
+  R_xlen_t size() const { return num_features; }
+
+  ~DataFrame_Features() { }
+};
+
+
+
+//========================
+// Rcpp-exported functions
+//========================
+
+
+// FeatureCollection from a data.frame ( properties ) and a geometry column. If 'path_to_file' is not an empty string then the output is streamed to the file
+// and an empty string is returned. The 'id_idx' is the 0-based index of the 'id' column ( -1 if the Features do not have an 'id' )
+//
+
+// [[Rcpp::export]]
+SEXP export_DataFrame_FeatureCollection(Rcpp::List data, Rcpp::List geometry, std::vector<std::string> geometry_type, bool ragged = false, int id_idx = -1,
+
+                                        std::string path_to_file = "", int precision = -1, bool profile = false) {
+
+  Phase_Profiler profiler(profile);
+
+  profiler.start("R extraction");
+
+  DataFrame_Features df_feat(data, geometry, geometry_type, ragged, id_idx);
+
+  GeoJson_Writer writer(precision);
+
+  if (path_to_file != "") {
+
+    if (!writer.open(path_to_file)) Rcpp::stop("the file '" + path_to_file + "' can not be opened for writing!");
+
+    profiler.start("serialization and write");                    // the output is streamed to the file while it is serialized
+
+    df_feat.write(writer);
+
+    long written_bytes = writer.file_position();                    // -1 in case of a gzip-compressed file
+
+    writer.close();
+
+    profiler.stop(std::max(written_bytes, 0L));
+
+    return profiler.attach(Rcpp::wrap(""));
+  }
+
+  writer.reserve(df_feat.estimate_size());
+
+  profiler.start("serialization");
+
+  df_feat.write(writer);
+
+  profiler.stop(writer.size());
+
+  return profiler.attach(Rcpp::wrap(writer.str()));
+}
@@ -0,0 +1,180 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file directory_walker.h
+ *
+ * @Notes: (recursive) listing of the files of a directory, which are filtered by the file extension. The type of the entries is taken from the 'd_type' of
+ *         'readdir()' where available, so that only the matching files are 'stat()'-ed ( for the size ). The sub-directories of each level are scanned in
+ *         parallel. It does not use the R API
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+
+
+struct Dir_Entry {
+
+  std::string path;
+
+  double size;                                              // in bytes
+
+  bool operator<(const Dir_Entry &other) const { return path < other.path; }
+};
+
+
+// true if the file-name ends in one of the extensions ( a leading '*' of an extension is ignored, i.e. "*.geojson" is the same as ".geojson" ). All files
+// match if the 'extensions' vector is empty
+//
+
+inline bool match_extension(const std::string &name, const std::vector<std::string> &extensions) {
+
+  if (extensions.empty()) return true;
+
+  for (size_t i = 0; i < extensions.size(); i++) {
+
+    const std::string &ext = extensions[i];
+
+    size_t offset = (!ext.empty() && ext[0] == '*') ? 1 : 0;
+
+    size_t len = ext.size() - offset;
+
+    if (name.size() >= len && name.compare(name.size() - len, len, ext, offset, len) == 0) return true;
+  }
+
+  return false;
+}
+
+
+// entries of a single directory : the matching files are appended to 'files' and the sub-directories to 'sub_dirs' ( 'dir_path' ends in a separator ). The
+// symbolic links to directories are not followed, so that the recursion does not include cycles
+//
+
+inline void read_directory_entries(const std::string &dir_path, const std::vector<std::string> &extensions, std::vector<Dir_Entry> &files, std::vector<std::string> &sub_dirs) {
+
+  DIR *dp = opendir(dir_path.empty() ? "." : dir_path.c_str());
+
+  if (dp == NULL) return;
+
+  dirent *de;
+
+  while ((de = readdir(dp)) != NULL) {
+
+    const char *name = de->d_name;
+
+    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+    std::string full_path = dir_path + name;
+
+    bool is_dir = false, is_file = false, known_type = false;
+
+#if defined(DT_DIR) && defined(DT_REG) && defined(DT_UNKNOWN)
+    if (de->d_type != DT_UNKNOWN && de->d_type != DT_LNK) {
+
+      is_dir = (de->d_type == DT_DIR);
+
+      is_file = (de->d_type == DT_REG);
+
+      known_type = true;
+    }
+#endif
+
+    if (known_type && is_dir) {
+
+      sub_dirs.push_back(full_path + "/");
+
+      continue;
+    }
+
+    if (known_type && !is_file) continue;                                     // sockets, pipes etc.
+
+    if (known_type && !match_extension(full_path, extensions)) continue;      // the files that do not match are not 'stat()'-ed
+
+    struct stat st;
+
+    if (stat(full_path.c_str(), &st) != 0) continue;
+
+    if (S_ISDIR(st.st_mode)) {                                                // unknown type ( or a symbolic link )
+
+      bool is_link = false;
+
+#ifndef _WIN32
+      struct stat lst;                                                        // 'lstat()' does not follow the link [ 'd_type' is DT_UNKNOWN on some file systems ]
+
+      is_link = (lstat(full_path.c_str(), &lst) != 0 || S_ISLNK(lst.st_mode));
+#endif
+
+      if (!is_link) sub_dirs.push_back(full_path + "/");
+
+      continue;
+    }
+
+    if (!S_ISREG(st.st_mode) || !match_extension(full_path, extensions)) continue;
+
+    Dir_Entry entry;
+
+    entry.path = full_path;
+
+    entry.size = static_cast<double>(st.st_size);
+
+    files.push_back(entry);
+  }
+
+  closedir(dp);
+}
+
+
+// files of the directory 'root' ( and of its sub-directories if 'recursive' is true ) sorted by path. The directories of each level of the tree are scanned
+// in parallel [ a tree of 'z/x/y' tiles has few directories in the first level, but many in the next levels ]
+//
+
+inline std::vector<Dir_Entry> walk_directory(std::string root, bool recursive, const std::vector<std::string> &extensions, int threads = 1) {
+
+  if (!root.empty() && root[root.size() - 1] != '/' && root[root.size() - 1] != '\\') root += "/";
+
+  if (threads < 1) threads = 1;
+
+  std::vector<Dir_Entry> result;
+
+  std::vector<std::string> level(1, root);
+
+  while (!level.empty()) {
+
+    int num_dirs = level.size();
+
+    std::vector<std::vector<Dir_Entry> > level_files(num_dirs);
+
+    std::vector<std::vector<std::string> > level_sub_dirs(num_dirs);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) if(num_dirs > 1)
+    #endif
+    for (int d = 0; d < num_dirs; d++) {
+
+      read_directory_entries(level[d], extensions, level_files[d], level_sub_dirs[d]);
+    }
+
+    std::vector<std::string> next_level;
+
+    for (int d = 0; d < num_dirs; d++) {
+
+      result.insert(result.end(), level_files[d].begin(), level_files[d].end());
+
+      if (recursive) next_level.insert(next_level.end(), level_sub_dirs[d].begin(), level_sub_dirs[d].end());
+    }
+
+    level.swap(next_level);
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
@@ -0,0 +1,462 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file feature_stage.h
+ *
+ * @Notes: first stage of the conversion of the Features of a 'FeatureCollection' ( see 'feature_collection_geojson()' in the 'FROM_geojson.cpp' file ). Each
+ *         parsed json11 Feature is converted to a compact C++ representation ( column-major coordinate buffers, typed property values and the per-feature
+ *         bounding box ). It does not use the R API, thus the Features are staged in parallel ( OpenMP tasks ) and the R objects are allocated afterwards from
+ *         the staged Features in the main thread. The strings and the nested property values point to the parsed json11 object, which must outlive the stage
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <exception>
+
+#include "json11.h"
+#include "simplify_geometry.h"
+
+
+// layout of the coordinates of a geometry in the R output
+//
+
+enum Stage_Layout {
+
+  STAGE_POINT,                                              // numeric vector of length 2
+  STAGE_POSITIONS,                                          // 'LineString', 'MultiPoint' and 'Polygon' without interior rings : a single matrix
+  STAGE_RINGS,                                              // 'MultiLineString' and 'Polygon' with interior rings : a list of a list of matrices
+  STAGE_MULTI                                               // 'MultiPolygon' : a list of matrices ( one ring ) or of lists of matrices ( interior rings )
+};
+
+
+// members of a Feature in the order of the json object ( the other members are ignored, the same as in 'feature_OBJ()' )
+//
+
+enum Stage_Member { MEMBER_TYPE, MEMBER_ID, MEMBER_BBOX, MEMBER_GEOMETRY, MEMBER_PROPERTIES };
+
+
+// column-major positions [ the 'n' x coordinates followed by the 'n' y coordinates ]
+//
+
+typedef std::vector<double> Stage_Positions;
+
+
+struct Stage_Geometry {
+
+  const std::string *type;
+
+  int layout;
+
+  std::vector<Stage_Positions> parts;                       // a single part for the 'STAGE_POINT' and 'STAGE_POSITIONS' layouts
+
+  std::vector<int> rings;                                   // 'STAGE_MULTI' : the number of rings of each polygon ( the polygons without rings are skipped )
+
+  Stage_Geometry() : type(NULL), layout(STAGE_POINT) { }
+};
+
+
+// property value [ the scalars are typed, whereas the arrays and the objects are converted recursively in the R stage ]
+//
+
+struct Stage_Property {
+
+  const std::string *name;
+
+  json11::Json::Type type;
+
+  double number;                                            // NUMBER and BOOL
+
+  const json11::Json *value;                                // STRING, ARRAY and OBJECT
+};
+
+
+struct Stage_Feature {
+
+  std::vector<int> members;
+
+  const std::string *type;
+
+  bool id_number;
+
+  double id_value;
+
+  const std::string *id_string;
+
+  std::vector<double> bbox;                                 // the "bbox" member of the input
+
+  Stage_Geometry geometry;
+
+  std::vector<Stage_Property> properties;
+
+  double feature_bbox[4];                                   // xmin, ymin, xmax, ymax of the converted positions [ 'feature_bbox' ]
+
+  std::string error;                                        // raised in the R stage ( in the order of the Features )
+
+  Stage_Feature() : type(NULL), id_number(false), id_value(0.0), id_string(NULL) {
+
+    feature_bbox[0] = feature_bbox[1] = std::numeric_limits<double>::infinity();
+
+    feature_bbox[2] = feature_bbox[3] = -std::numeric_limits<double>::infinity();
+  }
+};
+
+
+class Feature_Stager {
+
+private:
+
+  double simplify_tolerance;
+
+  bool flatten_coords, feature_bbox;
+
+
+  void bbox_update(Stage_Feature &feat, const double *x, const double *y, size_t n) {
+
+    double min_x = feat.feature_bbox[0], min_y = feat.feature_bbox[1], max_x = feat.feature_bbox[2], max_y = feat.feature_bbox[3];
+
+    for (size_t i = 0; i < n; i++) {
+
+      min_x = std::min(min_x, x[i]);
+
+      max_x = std::max(max_x, x[i]);
+
+      min_y = std::min(min_y, y[i]);
+
+      max_y = std::max(max_y, y[i]);
+    }
+
+    feat.feature_bbox[0] = min_x; feat.feature_bbox[1] = min_y; feat.feature_bbox[2] = max_x; feat.feature_bbox[3] = max_y;
+  }
+
+
+  // array of positions to a column-major buffer
+  //
+
+  Stage_Positions read_positions(const json11::Json::array &tmp_array) {
+
+    size_t n = tmp_array.size();
+
+    Stage_Positions xy(2 * n);
+
+    for (size_t i = 0; i < n; i++) {
+
+      xy[i] = tmp_array[i][0].number_value();
+
+      xy[n + i] = tmp_array[i][1].number_value();
+    }
+
+    return xy;
+  }
+
+
+  // keeps only the positions retained by the simplification and updates the bounding box
+  //
+
+  void keep_positions(Stage_Feature &feat, Stage_Positions &xy, const std::vector<int> &keep) {
+
+    size_t n = xy.size() / 2;
+
+    if (keep.size() != n) {
+
+      size_t m = keep.size();
+
+      Stage_Positions xy_keep(2 * m);
+
+      for (size_t i = 0; i < m; i++) {
+
+        xy_keep[i] = xy[keep[i]];
+
+        xy_keep[m + i] = xy[n + keep[i]];
+      }
+
+      xy.swap(xy_keep);
+
+      n = m;
+    }
+
+    if (feature_bbox) bbox_update(feat, xy.data(), xy.data() + n, n);
+  }
+
+
+  // array of positions to a column-major buffer, which keeps only the positions retained by the Douglas-Peucker algorithm [ if 'simplify' is TRUE ]
+  //
+
+  Stage_Positions positions(Stage_Feature &feat, const json11::Json::array &tmp_array, bool simplify, bool ring) {
+
+    Stage_Positions xy = read_positions(tmp_array);
+
+    size_t n = tmp_array.size();
+
+    std::vector<int> keep;
+
+    if (simplify && simplify_tolerance > 0.0) {
+
+      keep = simplify_positions(xy.data(), xy.data() + n, n, simplify_tolerance, ring);}
+
+    else {
+
+      keep.resize(n);
+
+      for (size_t i = 0; i < n; i++) keep[i] = i;
+    }
+
+    keep_positions(feat, xy, keep);
+
+    return xy;
+  }
+
+
+  // the rings of a Polygon, which are simplified together [ see 'simplify_polygon()' ]
+  //
+
+  void polygon_rings(Stage_Feature &feat, const json11::Json::array &poly_tmp) {
+
+    size_t num_rings = poly_tmp.size();
+
+    std::vector<Stage_Positions> rings(num_rings);
+
+    std::vector<const double *> x(num_rings), y(num_rings);
+
+    std::vector<int> n(num_rings);
+
+    for (size_t k = 0; k < num_rings; k++) {
+
+      rings[k] = read_positions(poly_tmp[k].array_items());
+
+      n[k] = rings[k].size() / 2;
+
+      x[k] = rings[k].data();
+
+      y[k] = rings[k].data() + n[k];
+    }
+
+    std::vector<std::vector<int> > keep;
+
+    if (simplify_tolerance > 0.0) {
+
+      keep = simplify_polygon(x, y, n, simplify_tolerance);}
+
+    else {
+
+      keep.resize(num_rings);
+
+      for (size_t k = 0; k < num_rings; k++) {
+
+        keep[k].resize(n[k]);
+
+        for (int i = 0; i < n[k]; i++) keep[k][i] = i;
+      }
+    }
+
+    for (size_t k = 0; k < num_rings; k++) {
+
+      keep_positions(feat, rings[k], keep[k]);
+
+      feat.geometry.parts.push_back(std::move(rings[k]));
+    }
+  }
+
+
+  // the same geometry types and layouts as the 'geom_OBJ()' function
+  //
+
+  bool geometry(Stage_Feature &feat, const json11::Json &tmp_geom) {
+
+    Stage_Geometry &geom = feat.geometry;
+
+    geom.type = &tmp_geom["type"].string_value();
+
+    const std::string &res_type = *geom.type;
+
+    const json11::Json &coords = tmp_geom["coordinates"];
+
+    size_t polygon_size = coords.array_items().size();
+
+    if (res_type == "Point") {
+
+      geom.layout = STAGE_POINT;
+
+      Stage_Positions xy = {coords[0].number_value(), coords[1].number_value()};
+
+      if (feature_bbox) bbox_update(feat, &xy[0], &xy[1], 1);
+
+      geom.parts.push_back(xy);
+    }
+
+    else if (res_type == "LineString" || res_type == "MultiPoint" || (res_type == "Polygon" && polygon_size == 1)) {
+
+      geom.layout = STAGE_POSITIONS;
+
+      if (res_type == "Polygon") {
+
+        geom.parts.push_back(positions(feat, coords[0].array_items(), true, true));}
+
+      else {
+
+        geom.parts.push_back(positions(feat, coords.array_items(), res_type == "LineString", false));
+      }
+    }
+
+    else if (res_type == "MultiLineString" || (res_type == "Polygon" && polygon_size > 1)) {
+
+      geom.layout = STAGE_RINGS;
+
+      if (res_type == "Polygon") {
+
+        polygon_rings(feat, coords.array_items());}
+
+      else {
+
+        for (auto &line : coords.array_items()) {
+
+          geom.parts.push_back(positions(feat, line.array_items(), true, false));
+        }
+      }
+    }
+
+    else if (res_type == "MultiPolygon") {
+
+      geom.layout = STAGE_MULTI;
+
+      for (auto &poly : coords.array_items()) {
+
+        const json11::Json::array &poly_tmp = poly.array_items();
+
+        if (poly_tmp.empty()) continue;
+
+        geom.rings.push_back(poly_tmp.size());
+
+        polygon_rings(feat, poly_tmp);
+      }
+    }
+
+    else {
+
+      feat.error = "invalid GeoJson geometry object --> geom_OBJ() function";
+
+      return false;
+    }
+
+    return true;
+  }
+
+
+  // the members of a Feature, the same as the 'feature_OBJ()' function
+  //
+
+  void members(const json11::Json &input_obj, Stage_Feature &feat) {
+
+    bool has_id = false;
+
+    for (auto &iter : input_obj.object_items()) {
+
+      if (iter.first == "type") {
+
+        feat.members.push_back(MEMBER_TYPE);
+
+        feat.type = &iter.second.string_value();}
+
+      else if (iter.first == "id" || iter.first == "_id") {                    // both members are returned as 'id' [ if both exist then the last one is kept ]
+
+        if (!has_id) feat.members.push_back(MEMBER_ID);
+
+        has_id = true;
+
+        if (iter.second.is_number()) {
+
+          feat.id_number = true;
+
+          feat.id_value = iter.second.number_value();}
+
+        else if (iter.second.is_string()) {
+
+          feat.id_number = false;
+
+          feat.id_string = &iter.second.string_value();}
+
+        else {
+
+          feat.error = "invalid type for the 'id' member --> feature_geojson_sequential() function";
+
+          return;
+        }
+      }
+
+      else if (iter.first == "bbox") {
+
+        feat.members.push_back(MEMBER_BBOX);
+
+        for (auto &it : iter.second.array_items()) {
+
+          feat.bbox.push_back(it.number_value());
+        }
+      }
+
+      else if (iter.first == "geometry") {
+
+        feat.members.push_back(MEMBER_GEOMETRY);
+
+        if (!geometry(feat, iter.second)) return;
+      }
+
+      else if (iter.first == "properties" && !flatten_coords) {
+
+        feat.members.push_back(MEMBER_PROPERTIES);
+
+        const json11::Json::object &props = iter.second.object_items();
+
+        feat.properties.reserve(props.size());
+
+        for (auto &item_prop : props) {
+
+          Stage_Property prop;
+
+          prop.name = &item_prop.first;
+
+          prop.type = item_prop.second.type();
+
+          prop.number = prop.type == json11::Json::BOOL ? item_prop.second.bool_value() : item_prop.second.number_value();
+
+          prop.value = &item_prop.second;
+
+          feat.properties.push_back(prop);
+        }
+      }
+    }
+  }
+
+
+public:
+
+  Feature_Stager(bool flatten_coords_ = false, double simplify_tolerance_ = 0.0, bool feature_bbox_ = false) : simplify_tolerance(simplify_tolerance_),
+
+                 flatten_coords(flatten_coords_), feature_bbox(feature_bbox_) { }
+
+
+  // stages a single Feature [ the errors are kept in 'feat.error', because exceptions can not leave an OpenMP task ]
+  //
+
+  void stage(const json11::Json &input_obj, Stage_Feature &feat) {
+
+    try {
+
+      members(input_obj, feat);
+    }
+
+    catch (const std::exception &ex) {
+
+      feat.error = ex.what();
+    }
+  }
+
+
+  ~Feature_Stager() { }
+};
+
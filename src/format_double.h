@@ -0,0 +1,137 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file format_double.h
+ *
+ * @Notes: formatting of doubles for the writers ( shortest representation which round-trips OR fixed number of decimal digits ). It uses
+ *         'std::to_chars' if it is available ( the package is compiled as C++17, see the 'Makevars' ), otherwise 'snprintf' with 15 or 17 significant
+ *         digits ( the locale does not matter because R uses LC_NUMERIC = "C" )
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define GEOJSONR_TO_CHARS
+#endif
+
+
+// writes 'value' to 'buf' ( at least 32 characters ) and returns the number of characters. If 'precision' is negative then the shortest representation which
+// round-trips is used, otherwise 'precision' decimal digits ( fixed notation, trailing zeros are removed ). Non-finite values are written as 'null' ( JSON )
+//
+
+inline int format_double(char *buf, double value, int precision = -1) {
+
+  if (!std::isfinite(value)) {
+
+    buf[0] = 'n'; buf[1] = 'u'; buf[2] = 'l'; buf[3] = 'l';
+
+    return 4;
+  }
+
+  int len = 0;
+
+  if (precision < 0) {
+
+#ifdef GEOJSONR_TO_CHARS
+
+    std::to_chars_result res = std::to_chars(buf, buf + 32, value);
+
+    len = res.ptr - buf;
+
+#else
+
+    len = snprintf(buf, 32, "%.15g", value);                                        // 15 significant digits if they round-trip ( most of the coordinates ),
+
+    if (std::strtod(buf, NULL) != value) len = snprintf(buf, 32, "%.17g", value);   // otherwise 17 digits, which always round-trip
+
+#endif
+
+    return len;
+  }
+
+  if (precision > 17) precision = 17;
+
+#ifdef GEOJSONR_TO_CHARS
+
+  std::to_chars_result res = std::to_chars(buf, buf + 32, value, std::chars_format::fixed, precision);
+
+  if (res.ec == std::errc()) {
+
+    len = res.ptr - buf;}
+
+  else {                                                                             // very large values do not fit in the buffer using the fixed notation
+
+    len = snprintf(buf, 32, "%.17g", value);
+
+    return len;
+  }
+
+#else
+
+  len = snprintf(buf, 32, "%.*f", precision, value);
+
+  if (len >= 32) {
+
+    len = snprintf(buf, 32, "%.17g", value);
+
+    return len;
+  }
+
+#endif
+
+  if (precision > 0) {                                                               // remove the trailing zeros ( and the decimal point )
+
+    while (len > 0 && buf[len - 1] == '0') len--;
+
+    if (len > 0 && buf[len - 1] == '.') len--;
+  }
+
+  if (len == 2 && buf[0] == '-' && buf[1] == '0') {                                  // "-0" after rounding
+
+    buf[0] = '0';
+
+    len = 1;
+  }
+
+  return len;
+}
+
+
+// appends the formatted 'value' to 'out'
+//
+
+inline void append_double(std::string &out, double value, int precision = -1) {
+
+  char buf[32];
+
+  int len = format_double(buf, value, precision);
+
+  out.append(buf, len);
+}
+
+
+// the formatted 'value' as a std::string
+//
+
+inline std::string double_to_string(double value, int precision = -1) {
+
+  char buf[32];
+
+  int len = format_double(buf, value, precision);
+
+  return std::string(buf, len);
+}
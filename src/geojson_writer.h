@@ -0,0 +1,656 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file geojson_writer.h
+ *
+ * @Notes: streaming writer, which appends JSON directly to a single output buffer ( OR streams it to a file in chunks, gzip-compressed if the path ends in '.gz' )
+ *         without building a json11 object.
+ *         The output has the same format as the 'json11::Json::dump()' function ( ", " and ": " separators, the caller writes the keys of an object sorted ).
+ *         It's included after the Rcpp headers
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include "format_double.h"
+#include "gzip_io.h"
+
+
+// read-only pointers to the data of a numeric vector [ 'REAL()' of an ALTREP object, for instance of a 'Lazy_Coords' matrix, requests a writable pointer,
+// which copies the data to R memory ]
+//
+
+inline const double *real_ro(SEXP data) {
+
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 5, 0)
+  return REAL_RO(data);
+#else
+  return REAL(data);
+#endif
+}
+
+
+inline const int *integer_ro(SEXP data) {
+
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 5, 0)
+  return INTEGER_RO(data);
+#else
+  return INTEGER(data);
+#endif
+}
+
+
+// approximate size ( in bytes ) of the json-dump of an R object, which is used to reserve the output buffer
+//
+
+inline size_t estimate_json_size(SEXP data) {
+
+  switch (TYPEOF(data)) {
+
+    case REALSXP: return 20 * Rf_xlength(data) + 2;
+
+    case INTSXP: return 12 * Rf_xlength(data) + 2;
+
+    case LGLSXP: return 7 * Rf_xlength(data) + 2;
+
+    case STRSXP: {
+
+      size_t res = 2;
+
+      for (R_xlen_t i = 0; i < Rf_xlength(data); i++) res += std::strlen(CHAR(STRING_ELT(data, i))) + 4;
+
+      return res;
+    }
+
+    case VECSXP: {
+
+      size_t res = 2;
+
+      for (R_xlen_t i = 0; i < Rf_xlength(data); i++) res += estimate_json_size(VECTOR_ELT(data, i)) + 16;         // including the key and the separators
+
+      return res;
+    }
+
+    default: return 8;
+  }
+}
+
+
+// nesting level of the coordinates of a geometry-type ( 0 if the geometry-type is not valid )
+//
+
+inline int geometry_type_depth(const std::string &geometry_type) {
+
+  if (geometry_type == "Point") return 1;
+
+  if (geometry_type == "MultiPoint" || geometry_type == "LineString") return 2;
+
+  if (geometry_type == "MultiLineString" || geometry_type == "Polygon") return 3;
+
+  if (geometry_type == "MultiPolygon") return 4;
+
+  return 0;
+}
+
+
+// view of the positions of a numeric matrix ( one position per row ) without copying the data. The coordinate 'j' of the row 'i' is at 'data[i + j * nrow]'
+// ( column-major, the stride between the coordinates of a position is 'nrow' ). If 'keep' is not empty then only these rows are used [ simplification ]
+//
+
+struct Matrix_View {
+
+  SEXP r_data;                                           // the R matrix
+
+  const double *data;
+
+  int nrow, ncol;
+
+  std::vector<int> keep;
+
+  Matrix_View() : r_data(R_NilValue), data(NULL), nrow(0), ncol(0) { }
+
+  Matrix_View(SEXP matrix) : r_data(matrix), data(real_ro(matrix)), nrow(Rf_nrows(matrix)), ncol(Rf_ncols(matrix)) { }
+
+  int size() const { return keep.empty() ? nrow : static_cast<int>(keep.size()); }
+
+  int row(int i) const { return keep.empty() ? i : keep[i]; }
+};
+
+
+class GeoJson_Writer {
+
+private:
+
+  std::string buf;
+
+  std::FILE *file;
+
+  gzFile gz_file;                                        // gzip-compressed output
+
+  size_t flush_size;                                     // the buffer is written to the file when it exceeds 'flush_size' bytes
+
+  int precision;                                         // negative : shortest representation which round-trips [ see 'format_double.h' ]
+
+public:
+
+  GeoJson_Writer(int precision_ = -1) : file(NULL), gz_file(NULL), flush_size(1 << 22), precision(precision_) { }
+
+
+  // open a file ( the output is streamed to the file instead of being kept in memory ). If the path ends in '.gz' then the output is gzip-compressed [ in
+  // append mode a new gzip member is added to the file, which is valid gzip data ]
+  //
+
+  bool open(const std::string &path_to_file, bool append = false, size_t flush_size_ = 1 << 22) {
+
+    if (is_gzip_path(path_to_file)) {
+
+      gz_file = gzopen(path_to_file.c_str(), append ? "ab6" : "wb6");
+
+      if (gz_file != NULL) gzbuffer(gz_file, 1 << 18);
+    }
+
+    else {
+
+      file = std::fopen(path_to_file.c_str(), append ? "ab" : "wb");
+    }
+
+    flush_size = flush_size_;
+
+    buf.reserve(flush_size + (flush_size >> 3));
+
+    return file != NULL || gz_file != NULL;
+  }
+
+
+  void reserve(size_t bytes) {
+
+    buf.reserve(bytes);
+  }
+
+
+  // writes 'size' bytes to the open file [ 'gzwrite()' takes an unsigned int length and returns an int, thus the data are compressed in chunks of 1 GB
+  // and each chunk must be written completely ]
+  //
+
+  bool write_bytes(const char *data, size_t size) {
+
+    if (gz_file != NULL) {
+
+      const size_t max_chunk = static_cast<size_t>(1) << 30;
+
+      while (size > 0) {
+
+        unsigned int chunk = static_cast<unsigned int>(size < max_chunk ? size : max_chunk);
+
+        if (gzwrite(gz_file, data, chunk) != static_cast<int>(chunk)) return false;
+
+        data += chunk;
+
+        size -= chunk;
+      }
+
+      return true;
+    }
+
+    return std::fwrite(data, 1, size, file) == size;
+  }
+
+
+  // write the buffer to the file [ if a file is open ]
+  //
+
+  void flush() {
+
+    if ((file != NULL || gz_file != NULL) && !buf.empty()) {
+
+      bool valid = write_bytes(buf.data(), buf.size());
+
+      buf.clear();
+
+      if (!valid) Rcpp::stop("the data could not be written to the output file!");
+    }
+  }
+
+
+  // it is called between items, so that the buffer size is bounded when the output is streamed to a file
+  //
+
+  void maybe_flush() {
+
+    if ((file != NULL || gz_file != NULL) && buf.size() >= flush_size) flush();
+  }
+
+
+  // writes a (large) block of data to the file without copying it to the buffer [ the buffer is written first, so that the order is kept ]
+  //
+
+  void write_direct(const std::string &data) {
+
+    if (file == NULL && gz_file == NULL) {
+
+      buf.append(data);
+
+      return;
+    }
+
+    flush();
+
+    if (data.empty()) return;
+
+    if (!write_bytes(data.data(), data.size())) Rcpp::stop("the data could not be written to the output file!");
+  }
+
+
+  // position of the end of the output in the ( uncompressed ) file, -1 if the output is not written to an uncompressed file
+  //
+
+  long file_position() {
+
+    if (file == NULL) return -1;
+
+    flush();
+
+    return std::ftell(file);
+  }
+
+
+  // overwrites the data at the 'offset' of the ( uncompressed ) file, for instance a placeholder that was written with 'file_position()' [ the output
+  // continues at the end of the file ]
+  //
+
+  bool patch(long offset, const std::string &data) {
+
+    if (file == NULL) return false;
+
+    flush();
+
+    bool valid = std::fseek(file, offset, SEEK_SET) == 0 && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+
+    return std::fseek(file, 0, SEEK_END) == 0 && valid;
+  }
+
+
+  // writes the buffer and closes the file [ the file is closed even if the write fails, and the result of the close is checked too, because the data
+  // which are buffered by the C library ( or the end of the gzip stream ) are written by 'fclose()' / 'gzclose()' ]
+  //
+
+  void close() {
+
+    bool valid = true;
+
+    if ((file != NULL || gz_file != NULL) && !buf.empty()) valid = write_bytes(buf.data(), buf.size());
+
+    buf.clear();
+
+    if (file != NULL) {
+
+      valid = (std::fclose(file) == 0) && valid;
+
+      file = NULL;
+    }
+
+    if (gz_file != NULL) {
+
+      valid = (gzclose(gz_file) == Z_OK) && valid;
+
+      gz_file = NULL;
+    }
+
+    if (!valid) Rcpp::stop("the data could not be written to the output file!");
+  }
+
+
+  // closes the file without writing the buffer [ the output is discarded, for instance after an error, thus it does not throw ]
+  //
+
+  void discard() {
+
+    buf.clear();
+
+    if (file != NULL) {
+
+      std::fclose(file);
+
+      file = NULL;
+    }
+
+    if (gz_file != NULL) {
+
+      gzclose(gz_file);
+
+      gz_file = NULL;
+    }
+  }
+
+
+  std::string &str() { return buf; }
+
+  size_t size() const { return buf.size(); }
+
+
+  //---------------------------------------------------------------- primitives
+
+  void put(char c) { buf.push_back(c); }
+
+  void put(const char *s) { buf.append(s); }
+
+  void put(const std::string &s) { buf.append(s); }
+
+  void put_double(double value) { append_double(buf, value, precision); }
+
+  void put_int(int value) {
+
+    if (value == NA_INTEGER) {
+
+      buf.append("null");}
+
+    else {
+
+      char tmp[16];
+
+      int len = snprintf(tmp, sizeof tmp, "%d", value);
+
+      buf.append(tmp, len);
+    }
+  }
+
+  void put_bool(int value) {
+
+    if (value == NA_LOGICAL) {
+
+      buf.append("null");}
+
+    else {
+
+      buf.append(value ? "true" : "false");
+    }
+  }
+
+  void put_null() { buf.append("null"); }
+
+  void sep() { buf.append(", "); }                     // separator of the items of an array or object
+
+  void key(const char *name) {                         // "name": ( the names of the GeoJson members do not require escaping )
+
+    buf.push_back('"');
+
+    buf.append(name);
+
+    buf.append("\": ");
+  }
+
+
+  // escaped JSON string [ the same escaping as in 'json11.cpp' ]
+  //
+
+  void put_string(const char *value, size_t length) {
+
+    buf.push_back('"');
+
+    for (size_t i = 0; i < length; i++) {
+
+      const char ch = value[i];
+
+      if (ch == '\\') {
+        buf.append("\\\\");
+      } else if (ch == '"') {
+        buf.append("\\\"");
+      } else if (ch == '\b') {
+        buf.append("\\b");
+      } else if (ch == '\f') {
+        buf.append("\\f");
+      } else if (ch == '\n') {
+        buf.append("\\n");
+      } else if (ch == '\r') {
+        buf.append("\\r");
+      } else if (ch == '\t') {
+        buf.append("\\t");
+      } else if (static_cast<uint8_t>(ch) <= 0x1f) {
+        char tmp[8];
+        snprintf(tmp, sizeof tmp, "\\u%04x", ch);
+        buf.append(tmp);
+      } else if (static_cast<uint8_t>(ch) == 0xe2 && i + 2 < length && static_cast<uint8_t>(value[i+1]) == 0x80
+                 && static_cast<uint8_t>(value[i+2]) == 0xa8) {
+        buf.append("\\u2028");
+        i += 2;
+      } else if (static_cast<uint8_t>(ch) == 0xe2 && i + 2 < length && static_cast<uint8_t>(value[i+1]) == 0x80
+                 && static_cast<uint8_t>(value[i+2]) == 0xa9) {
+        buf.append("\\u2029");
+        i += 2;
+      } else {
+        buf.push_back(ch);
+      }
+    }
+
+    buf.push_back('"');
+  }
+
+  void put_string(const std::string &value) { put_string(value.data(), value.size()); }
+
+  void put_string(SEXP charsxp) {                      // an item of a character vector ( NA : null )
+
+    if (charsxp == NA_STRING) {
+
+      buf.append("null");}
+
+    else {
+
+      const char *tmp = CHAR(charsxp);
+
+      put_string(tmp, std::strlen(tmp));
+    }
+  }
+
+
+  //---------------------------------------------------------------- nested std::vectors [ coordinates of the 'GeoJson_Geometries' class ]
+
+  void put_nested(double value) { put_double(value); }
+
+  template<class T>
+  void put_nested(const std::vector<T> &data) {
+
+    buf.push_back('[');
+
+    for (size_t i = 0; i < data.size(); i++) {
+
+      if (i > 0) sep();
+
+      put_nested(data[i]);
+    }
+
+    buf.push_back(']');
+  }
+
+
+  void put_nested(const Matrix_View &data) {           // array of the positions ( rows ) of a matrix
+
+    buf.push_back('[');
+
+    for (int i = 0; i < data.size(); i++) {
+
+      if (i > 0) sep();
+
+      const double *position = data.data + data.row(i);
+
+      buf.push_back('[');
+
+      for (int j = 0; j < data.ncol; j++) {
+
+        if (j > 0) sep();
+
+        put_double(position[static_cast<R_xlen_t>(j) * data.nrow]);
+      }
+
+      buf.push_back(']');
+    }
+
+    buf.push_back(']');
+  }
+
+
+  //---------------------------------------------------------------- R objects
+
+  // coordinates : a numeric vector is a position, a numeric matrix an array of positions ( rows ) and a list an array of its items. If 'depth' ( the nesting
+  // level of the geometry-type, see 'geometry_type_depth()' ) is greater than 0 then the missing levels are added, i.e. a matrix of a 'Polygon' is a single
+  // ring and a matrix of a 'MultiPolygon' a polygon without interior rings [ as in the output of the 'FROM_GeoJson' function ]
+  //
+
+  void put_coordinates(SEXP data, int depth = 0) {
+
+    int type = TYPEOF(data);
+
+    if (type == VECSXP) {
+
+      R_xlen_t n = Rf_xlength(data);
+
+      buf.push_back('[');
+
+      for (R_xlen_t i = 0; i < n; i++) {
+
+        if (i > 0) sep();
+
+        put_coordinates(VECTOR_ELT(data, i), depth > 0 ? depth - 1 : 0);
+      }
+
+      buf.push_back(']');
+    }
+
+    else if (type == REALSXP || type == INTSXP) {
+
+      bool is_real = (type == REALSXP);
+
+      bool is_matrix = Rf_isMatrix(data);
+
+      const double *real_data = is_real ? real_ro(data) : NULL;                  // once per vector ( integer NA's are written as null )
+
+      const int *int_data = is_real ? NULL : integer_ro(data);
+
+      if (depth > (is_matrix ? 2 : 1)) {
+
+        buf.push_back('[');
+
+        put_coordinates(data, depth - 1);
+
+        buf.push_back(']');
+      }
+
+      else if (is_matrix) {
+
+        int nrow = Rf_nrows(data), ncol = Rf_ncols(data);
+
+        buf.push_back('[');
+
+        for (int i = 0; i < nrow; i++) {
+
+          if (i > 0) sep();
+
+          buf.push_back('[');
+
+          for (int j = 0; j < ncol; j++) {
+
+            if (j > 0) sep();
+
+            R_xlen_t idx = i + static_cast<R_xlen_t>(j) * nrow;
+
+            if (is_real) {
+
+              put_double(real_data[idx]);}
+
+            else {
+
+              put_int(int_data[idx]);
+            }
+          }
+
+          buf.push_back(']');
+        }
+
+        buf.push_back(']');
+      }
+
+      else {
+
+        R_xlen_t n = Rf_xlength(data);
+
+        buf.push_back('[');
+
+        for (R_xlen_t i = 0; i < n; i++) {
+
+          if (i > 0) sep();
+
+          if (is_real) {
+
+            put_double(real_data[i]);}
+
+          else {
+
+            put_int(int_data[i]);
+          }
+        }
+
+        buf.push_back(']');
+      }
+    }
+
+    else {
+
+      Rcpp::stop("the coordinates should be numeric vectors, numeric matrices or lists --> GeoJson_Writer::put_coordinates() function");
+    }
+  }
+
+
+  // a single item of an atomic vector
+  //
+
+  void put_atomic_item(SEXP data, R_xlen_t i) {
+
+    switch (TYPEOF(data)) {
+
+      case REALSXP: put_double(real_ro(data)[i]); break;
+
+      case INTSXP: put_int(integer_ro(data)[i]); break;
+
+      case LGLSXP: put_bool(LOGICAL(data)[i]); break;
+
+      case STRSXP: put_string(STRING_ELT(data, i)); break;
+
+      default: Rcpp::stop("invalid atomic vector --> GeoJson_Writer::put_atomic_item() function");
+    }
+  }
+
+
+  // all items of an atomic vector as a JSON array
+  //
+
+  void put_atomic_array(SEXP data) {
+
+    R_xlen_t n = Rf_xlength(data);
+
+    buf.push_back('[');
+
+    for (R_xlen_t i = 0; i < n; i++) {
+
+      if (i > 0) sep();
+
+      put_atomic_item(data, i);
+    }
+
+    buf.push_back(']');
+  }
+
+
+  ~GeoJson_Writer() {
+
+    if (file != NULL) std::fclose(file);
+
+    if (gz_file != NULL) gzclose(gz_file);
+  }
+};
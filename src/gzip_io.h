@@ -0,0 +1,123 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file gzip_io.h
+ *
+ * @Notes: reading of plain or gzip-compressed files ( the compression is detected from the magic bytes ) and helpers for the gzip-compressed output of the
+ *         writers ( a path that ends in '.gz' ). It uses zlib ( -lz in the Makevars )
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <cstdio>
+#include <algorithm>
+
+#include <zlib.h>
+
+
+// the output is gzip-compressed if the path ends in '.gz'
+//
+
+inline bool is_gzip_path(const std::string &path) {
+
+  return path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+}
+
+
+// reads the content of a file in a single (bulk) read OR inflates it in chunks if it's gzip-compressed. It does not use the R API, thus it can be called from
+// multiple threads. It returns false if the file can not be opened or if the compressed data are invalid
+//
+
+inline bool read_file_contents(const std::string &path, std::string &data_in) {
+
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+
+  if (file == NULL) return false;
+
+  unsigned char magic[2] = {0, 0};
+
+  size_t num_magic = std::fread(magic, 1, 2, file);
+
+  bool gzipped = (num_magic == 2 && magic[0] == 0x1f && magic[1] == 0x8b);
+
+  std::fseek(file, 0, SEEK_END);
+
+  long size_file = std::ftell(file);
+
+  if (!gzipped) {
+
+    data_in.clear();
+
+    if (size_file > 0) {
+
+      std::fseek(file, 0, SEEK_SET);
+
+      data_in.resize(static_cast<size_t>(size_file));
+
+      size_t num_read = std::fread(&data_in[0], 1, data_in.size(), file);
+
+      data_in.resize(num_read);
+    }
+
+    std::fclose(file);
+
+    return true;
+  }
+
+  size_t size_hint = 0;                                                  // the last 4 bytes of a gzip member are the uncompressed size ( modulo 2^32 )
+
+  if (size_file >= 18) {
+
+    unsigned char isize[4];
+
+    std::fseek(file, -4, SEEK_END);
+
+    if (std::fread(isize, 1, 4, file) == 4) {
+
+      size_hint = static_cast<size_t>(isize[0]) | (static_cast<size_t>(isize[1]) << 8) | (static_cast<size_t>(isize[2]) << 16) | (static_cast<size_t>(isize[3]) << 24);
+    }
+  }
+
+  std::fclose(file);
+
+  gzFile gz_file = gzopen(path.c_str(), "rb");
+
+  if (gz_file == NULL) return false;
+
+  gzbuffer(gz_file, 1 << 18);
+
+  data_in.clear();
+
+  data_in.reserve(std::max(size_hint, static_cast<size_t>(size_file) * 4));
+
+  const int chunk = 1 << 20;
+
+  std::string buf(chunk, '\0');
+
+  bool valid = true;
+
+  while (true) {
+
+    int num_read = gzread(gz_file, &buf[0], chunk);
+
+    if (num_read < 0) {
+
+      valid = false;
+
+      break;
+    }
+
+    if (num_read == 0) break;
+
+    data_in.append(buf.data(), num_read);
+  }
+
+  gzclose(gz_file);
+
+  return valid;
+}
+
@@ -9,37 +9,70 @@
 
 /* .Call calls */
 extern SEXP _geojsonR_DATA_TYPE(SEXP);
-extern SEXP _geojsonR_dump_geojson(SEXP);
-extern SEXP _geojsonR_export_From_geojson(SEXP, SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_export_From_geojson_schema(SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_dump_geojson(SEXP, SEXP);
+extern SEXP _geojsonR_export_alloc_stats(SEXP, SEXP);
+extern SEXP _geojsonR_export_DataFrame_FeatureCollection(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_fc_writer_append(SEXP, SEXP);
+extern SEXP _geojsonR_export_fc_writer_close(SEXP);
+extern SEXP _geojsonR_export_fc_writer_open(SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_From_geojson(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_From_geojson_files(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_From_geojson_schema(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP _geojsonR_export_From_JSON(SEXP);
-extern SEXP _geojsonR_export_To_GeoJson(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_Feature_collection_Obj(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_GeoJson_Seq(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_point_in_polygon(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_point_in_polygon_flat(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_query_bbox(SEXP, SEXP);
+extern SEXP _geojsonR_export_query_point(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_spatial_index(SEXP, SEXP);
+extern SEXP _geojsonR_export_To_GeoJson(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_export_To_GeoJson_matrix(SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_Feature_collection_Obj(SEXP, SEXP, SEXP, SEXP);
 extern SEXP _geojsonR_Feature_Obj(SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_Features_TO_Collection(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_Features_TO_Collection(SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP _geojsonR_Geom_Collection(SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_inner_coords(SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_list_files(SEXP, SEXP);
-extern SEXP _geojsonR_merge_json(SEXP, SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_Polygon_with_interior_rings(SEXP, SEXP, SEXP);
-extern SEXP _geojsonR_SAVE_R_list_Features_2_FeatureCollection(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_list_files(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_list_files_sizes(SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_long_format_offsets(SEXP);
+extern SEXP _geojsonR_merge_json(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_ragged_geometries_list(SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_SAVE_R_list_Features_2_FeatureCollection(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _geojsonR_splice_Features_TO_Collection(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+
+/* ALTREP classes [ see 'lazy_coords.cpp' ] */
+extern void geojsonR_init_altrep(DllInfo *dll);
 
 static const R_CallMethodDef CallEntries[] = {
     {"_geojsonR_DATA_TYPE",                                (DL_FUNC) &_geojsonR_DATA_TYPE,                                1},
-    {"_geojsonR_dump_geojson",                             (DL_FUNC) &_geojsonR_dump_geojson,                             1},
-    {"_geojsonR_export_From_geojson",                      (DL_FUNC) &_geojsonR_export_From_geojson,                      4},
-    {"_geojsonR_export_From_geojson_schema",               (DL_FUNC) &_geojsonR_export_From_geojson_schema,               4},
+    {"_geojsonR_dump_geojson",                             (DL_FUNC) &_geojsonR_dump_geojson,                             2},
+    {"_geojsonR_export_alloc_stats",                       (DL_FUNC) &_geojsonR_export_alloc_stats,                       2},
+    {"_geojsonR_export_DataFrame_FeatureCollection",       (DL_FUNC) &_geojsonR_export_DataFrame_FeatureCollection,       8},
+    {"_geojsonR_export_fc_writer_append",                  (DL_FUNC) &_geojsonR_export_fc_writer_append,                  2},
+    {"_geojsonR_export_fc_writer_close",                   (DL_FUNC) &_geojsonR_export_fc_writer_close,                   1},
+    {"_geojsonR_export_fc_writer_open",                    (DL_FUNC) &_geojsonR_export_fc_writer_open,                    4},
+    {"_geojsonR_export_From_geojson",                      (DL_FUNC) &_geojsonR_export_From_geojson,                      11},
+    {"_geojsonR_export_From_geojson_files",                (DL_FUNC) &_geojsonR_export_From_geojson_files,                11},
+    {"_geojsonR_export_From_geojson_schema",               (DL_FUNC) &_geojsonR_export_From_geojson_schema,               7},
     {"_geojsonR_export_From_JSON",                         (DL_FUNC) &_geojsonR_export_From_JSON,                         1},
-    {"_geojsonR_export_To_GeoJson",                        (DL_FUNC) &_geojsonR_export_To_GeoJson,                        6},
-    {"_geojsonR_Feature_collection_Obj",                   (DL_FUNC) &_geojsonR_Feature_collection_Obj,                   3},
+    {"_geojsonR_export_GeoJson_Seq",                       (DL_FUNC) &_geojsonR_export_GeoJson_Seq,                       6},
+    {"_geojsonR_export_point_in_polygon",                  (DL_FUNC) &_geojsonR_export_point_in_polygon,                  3},
+    {"_geojsonR_export_point_in_polygon_flat",             (DL_FUNC) &_geojsonR_export_point_in_polygon_flat,             3},
+    {"_geojsonR_export_query_bbox",                        (DL_FUNC) &_geojsonR_export_query_bbox,                        2},
+    {"_geojsonR_export_query_point",                       (DL_FUNC) &_geojsonR_export_query_point,                       3},
+    {"_geojsonR_export_spatial_index",                     (DL_FUNC) &_geojsonR_export_spatial_index,                     2},
+    {"_geojsonR_export_To_GeoJson",                        (DL_FUNC) &_geojsonR_export_To_GeoJson,                        7},
+    {"_geojsonR_export_To_GeoJson_matrix",                 (DL_FUNC) &_geojsonR_export_To_GeoJson_matrix,                 4},
+    {"_geojsonR_Feature_collection_Obj",                   (DL_FUNC) &_geojsonR_Feature_collection_Obj,                   4},
     {"_geojsonR_Feature_Obj",                              (DL_FUNC) &_geojsonR_Feature_Obj,                              3},
-    {"_geojsonR_Features_TO_Collection",                   (DL_FUNC) &_geojsonR_Features_TO_Collection,                   3},
+    {"_geojsonR_Features_TO_Collection",                   (DL_FUNC) &_geojsonR_Features_TO_Collection,                   5},
     {"_geojsonR_Geom_Collection",                          (DL_FUNC) &_geojsonR_Geom_Collection,                          3},
-    {"_geojsonR_inner_coords",                             (DL_FUNC) &_geojsonR_inner_coords,                             3},
-    {"_geojsonR_list_files",                               (DL_FUNC) &_geojsonR_list_files,                               2},
-    {"_geojsonR_merge_json",                               (DL_FUNC) &_geojsonR_merge_json,                               4},
-    {"_geojsonR_Polygon_with_interior_rings",              (DL_FUNC) &_geojsonR_Polygon_with_interior_rings,              3},
-    {"_geojsonR_SAVE_R_list_Features_2_FeatureCollection", (DL_FUNC) &_geojsonR_SAVE_R_list_Features_2_FeatureCollection, 3},
+    {"_geojsonR_list_files",                               (DL_FUNC) &_geojsonR_list_files,                               5},
+    {"_geojsonR_list_files_sizes",                         (DL_FUNC) &_geojsonR_list_files_sizes,                         4},
+    {"_geojsonR_long_format_offsets",                      (DL_FUNC) &_geojsonR_long_format_offsets,                      1},
+    {"_geojsonR_merge_json",                               (DL_FUNC) &_geojsonR_merge_json,                               8},
+    {"_geojsonR_ragged_geometries_list",                   (DL_FUNC) &_geojsonR_ragged_geometries_list,                   3},
+    {"_geojsonR_SAVE_R_list_Features_2_FeatureCollection", (DL_FUNC) &_geojsonR_SAVE_R_list_Features_2_FeatureCollection, 8},
+    {"_geojsonR_splice_Features_TO_Collection",            (DL_FUNC) &_geojsonR_splice_Features_TO_Collection,            7},
     {NULL, NULL, 0}
 };
 
@@ -47,4 +80,5 @@ void R_init_geojsonR(DllInfo *dll)
 {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    geojsonR_init_altrep(dll);
 }
@@ -20,12 +20,16 @@
  */
 
 #include "json11.h"
+#include "format_double.h"
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
 #include <limits>
 #include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <exception>
 
 namespace json11 {
 
@@ -55,13 +59,7 @@ static void dump(NullStruct, string &out) {
 }
 
 static void dump(double value, string &out) {
-    if (std::isfinite(value)) {
-        char buf[32];
-        snprintf(buf, sizeof buf, "%.17g", value);
-        out += buf;
-    } else {
-        out += "null";
-    }
+    append_double(out, value);          // shortest representation which round-trips, 'null' if not finite [ see 'format_double.h' ]
 }
 
 static void dump(int value, string &out) {
@@ -141,6 +139,96 @@ void Json::dump(string &out) const {
     m_ptr->dump(out);
 }
 
+/* Parallel serialization ( geojsonR ). Each chunk of items is serialized into a separate buffer, which
+ * is reserved from the size of the first item of the chunk. The buffers are then copied in order to
+ * their offsets in the output. Arrays with fewer than 'parallel_min_items' items are serialized by dump().
+ */
+#ifdef _OPENMP
+static const size_t parallel_min_items = 256;
+
+static bool dump_in_parallel(const Json &value, int threads) {
+    return threads > 1 && value.is_array() && value.array_items().size() >= parallel_min_items;
+}
+
+static void dump_parallel(const Json::array &values, string &out, int threads) {
+    size_t n = values.size();
+    size_t num_chunks = std::min(n, static_cast<size_t>(threads) * 8);
+    vector<string> chunks(num_chunks);
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (long long c = 0; c < static_cast<long long>(num_chunks); c++) {
+        try {
+            size_t begin = n * c / num_chunks, end = n * (c + 1) / num_chunks;
+            string &buf = chunks[c];
+            values[begin].dump(buf);
+            buf.reserve((buf.size() + 2) * (end - begin + 1));
+            for (size_t i = begin + 1; i < end; i++) {
+                buf += ", ";
+                values[i].dump(buf);
+            }
+        } catch (...) {
+            #pragma omp critical
+            error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    vector<size_t> offsets(num_chunks);
+    size_t pos = out.size() + 1;
+    for (size_t c = 0; c < num_chunks; c++) {
+        if (c > 0)
+            pos += 2;
+        offsets[c] = pos;
+        pos += chunks[c].size();
+    }
+
+    size_t start = out.size();
+    out.resize(pos + 1);
+    out[start] = '[';
+    for (size_t c = 1; c < num_chunks; c++) {
+        out[offsets[c] - 2] = ',';
+        out[offsets[c] - 1] = ' ';
+    }
+    out[pos] = ']';
+
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (long long c = 0; c < static_cast<long long>(num_chunks); c++) {
+        std::copy(chunks[c].begin(), chunks[c].end(), out.begin() + offsets[c]);
+        string().swap(chunks[c]);
+    }
+}
+#endif
+
+void Json::dump(string &out, int threads) const {
+#ifdef _OPENMP
+    if (dump_in_parallel(*this, threads)) {
+        dump_parallel(array_items(), out, threads);
+        return;
+    }
+    if (threads > 1 && is_object()) {                   // the same format as dump(const Json::object &)
+        bool first = true;
+        out += "{";
+        for (const auto &kv : object_items()) {
+            if (!first)
+                out += ", ";
+            json11::dump(kv.first, out);
+            out += ": ";
+            if (dump_in_parallel(kv.second, threads))
+                dump_parallel(kv.second.array_items(), out, threads);
+            else
+                kv.second.dump(out);
+            first = false;
+        }
+        out += "}";
+        return;
+    }
+#endif
+    dump(out);
+}
+
 /* * * * * * * * * * * * * * * * * * * *
  * Value wrappers
  */
@@ -252,16 +340,92 @@ static const Json & static_null() {
 
 Json::Json() noexcept                  : m_ptr(statics().null) {}
 Json::Json(std::nullptr_t) noexcept    : m_ptr(statics().null) {}
-Json::Json(double value)               : m_ptr(make_shared<JsonDouble>(value)) {}
-Json::Json(int value)                  : m_ptr(make_shared<JsonInt>(value)) {}
+Json::Json(double value)               : m_ptr(make_shared<JsonDouble>(value)) { track_alloc(); }
+Json::Json(int value)                  : m_ptr(make_shared<JsonInt>(value)) { track_alloc(); }
 Json::Json(bool value)                 : m_ptr(value ? statics().t : statics().f) {}
-Json::Json(const string &value)        : m_ptr(make_shared<JsonString>(value)) {}
-Json::Json(string &&value)             : m_ptr(make_shared<JsonString>(std::move(value))) {}
-Json::Json(const char * value)         : m_ptr(make_shared<JsonString>(value)) {}
-Json::Json(const Json::array &values)  : m_ptr(make_shared<JsonArray>(values)) {}
-Json::Json(Json::array &&values)       : m_ptr(make_shared<JsonArray>(std::move(values))) {}
-Json::Json(const Json::object &values) : m_ptr(make_shared<JsonObject>(values)) {}
-Json::Json(Json::object &&values)      : m_ptr(make_shared<JsonObject>(std::move(values))) {}
+Json::Json(const string &value)        : m_ptr(make_shared<JsonString>(value)) { track_alloc(); }
+Json::Json(string &&value)             : m_ptr(make_shared<JsonString>(std::move(value))) { track_alloc(); }
+Json::Json(const char * value)         : m_ptr(make_shared<JsonString>(value)) { track_alloc(); }
+Json::Json(const Json::array &values)  : m_ptr(make_shared<JsonArray>(values)) { track_alloc(); }
+Json::Json(Json::array &&values)       : m_ptr(make_shared<JsonArray>(std::move(values))) { track_alloc(); }
+Json::Json(const Json::object &values) : m_ptr(make_shared<JsonObject>(values)) { track_alloc(); }
+Json::Json(Json::object &&values)      : m_ptr(make_shared<JsonObject>(std::move(values))) { track_alloc(); }
+
+/* * * * * * * * * * * * * * * * * * * *
+ * Allocation counters
+ */
+
+static std::atomic<bool> alloc_tracking_enabled(false);
+static std::atomic<unsigned long long> alloc_counts[ALLOC_NODE_TYPES];
+static std::atomic<unsigned long long> alloc_bytes[ALLOC_NODE_TYPES];
+
+static const size_t shared_ptr_overhead = 16;        // control block of 'make_shared' ( reference counts )
+static const size_t map_node_overhead = 32;          // red-black tree node of 'std::map' ( pointers and color )
+
+// heap buffer of a string ( 0 if the string fits in the small-string buffer )
+static size_t string_heap_bytes(const string &value) {
+    return (value.capacity() > 15) ? value.capacity() + 1 : 0;
+}
+
+void Json::track_alloc() const {
+    if (!alloc_tracking_enabled.load(std::memory_order_relaxed)) return;
+
+    AllocNode node;
+    size_t bytes = shared_ptr_overhead;
+
+    switch (m_ptr->type()) {
+        case NUMBER:
+            if (dynamic_cast<const JsonInt *>(m_ptr.get()) != nullptr) {
+                node = ALLOC_INT;
+                bytes += sizeof(JsonInt);
+            } else {
+                node = ALLOC_DOUBLE;
+                bytes += sizeof(JsonDouble);
+            }
+            break;
+        case STRING:
+            node = ALLOC_STRING;
+            bytes += sizeof(JsonString) + string_heap_bytes(m_ptr->string_value());
+            break;
+        case ARRAY:
+            node = ALLOC_ARRAY;
+            bytes += sizeof(JsonArray) + m_ptr->array_items().capacity() * sizeof(Json);
+            break;
+        case OBJECT:
+            node = ALLOC_OBJECT;
+            bytes += sizeof(JsonObject);
+            for (auto &item : m_ptr->object_items())
+                bytes += sizeof(Json::object::value_type) + map_node_overhead + string_heap_bytes(item.first);
+            break;
+        default:
+            return;
+    }
+
+    alloc_counts[node].fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes[node].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void set_alloc_tracking(bool enable) {
+    alloc_tracking_enabled.store(enable);
+}
+
+bool alloc_tracking() {
+    return alloc_tracking_enabled.load(std::memory_order_relaxed);
+}
+
+void alloc_stats(unsigned long long counts[ALLOC_NODE_TYPES], unsigned long long bytes[ALLOC_NODE_TYPES]) {
+    for (int i = 0; i < ALLOC_NODE_TYPES; i++) {
+        counts[i] = alloc_counts[i].load();
+        bytes[i] = alloc_bytes[i].load();
+    }
+}
+
+void reset_alloc_stats() {
+    for (int i = 0; i < ALLOC_NODE_TYPES; i++) {
+        alloc_counts[i].store(0);
+        alloc_bytes[i].store(0);
+    }
+}
 
 /* * * * * * * * * * * * * * * * * * * *
  * Accessors
@@ -349,6 +513,8 @@ struct JsonParser final {
     string &err;
     bool failed;
     const JsonParse strategy;
+    const ParseProgress *progress;     // nullptr : no progress callback
+    size_t next_progress;
 
     /* fail(msg, err_ret = Json())
      *
@@ -647,6 +813,12 @@ struct JsonParser final {
             return fail("exceeded maximum nesting depth");
         }
 
+        if (progress && i >= next_progress) {
+            next_progress = i + progress->interval;
+            if (!progress->callback(i, str.size()))
+                return fail("the parse was interrupted");
+        }
+
         char ch = get_next_token();
         if (failed)
             return Json();
@@ -730,8 +902,8 @@ struct JsonParser final {
 };
 }//namespace {
 
-Json Json::parse(const string &in, string &err, JsonParse strategy) {
-    JsonParser parser { in, 0, err, false, strategy };
+static Json parse_input(const string &in, string &err, JsonParse strategy, const ParseProgress *progress) {
+    JsonParser parser { in, 0, err, false, strategy, progress, progress ? progress->interval : 0 };
     Json result = parser.parse_json(0);
 
     // Check for any trailing garbage
@@ -742,12 +914,20 @@ Json Json::parse(const string &in, string &err, JsonParse strategy) {
     return result;
 }
 
+Json Json::parse(const string &in, string &err, JsonParse strategy) {
+    return parse_input(in, err, strategy, nullptr);
+}
+
+Json Json::parse(const string &in, string &err, JsonParse strategy, const ParseProgress &progress) {
+    return parse_input(in, err, strategy, &progress);
+}
+
 // Documented in json11.hpp
 vector<Json> Json::parse_multi(const string &in,
                                std::string::size_type &parser_stop_pos,
                                string &err,
                                JsonParse strategy) {
-    JsonParser parser { in, 0, err, false, strategy };
+    JsonParser parser { in, 0, err, false, strategy, nullptr, 0 };
     parser_stop_pos = 0;
     vector<Json> json_vec;
     while (parser.i != in.size() && !parser.failed) {
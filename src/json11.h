@@ -54,6 +54,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
 #include <initializer_list>
 
 #ifdef _MSC_VER
@@ -74,6 +75,15 @@ enum JsonParse {
     STANDARD, COMMENTS
 };
 
+/* Progress of a parse ( geojsonR ). The 'callback' is called by the thread of the parse about every
+ * 'interval' bytes with the position in the input and the size of the input. If it returns false then
+ * the parse stops and it fails with the error "the parse was interrupted".
+ */
+struct ParseProgress {
+    std::function<bool(size_t, size_t)> callback;
+    size_t interval;
+};
+
 class JsonValue;
 
 class Json final {
@@ -160,10 +170,24 @@ public:
         return out;
     }
 
+    // Serialize using 'threads' ( geojsonR ). The large arrays of the top level or of the members of a
+    // top-level object ( for instance the "features" of a FeatureCollection ) are split into chunks, which
+    // are serialized in parallel. The output is the same as the output of dump().
+    void dump(std::string &out, int threads) const;
+    std::string dump(int threads) const {
+        std::string out;
+        dump(out, threads);
+        return out;
+    }
+
     // Parse. If parse fails, return Json() and assign an error message to err.
     static Json parse(const std::string & in,
                       std::string & err,
                       JsonParse strategy = JsonParse::STANDARD);
+    static Json parse(const std::string & in,
+                      std::string & err,
+                      JsonParse strategy,
+                      const ParseProgress & progress);
     static Json parse(const char * in,
                       std::string & err,
                       JsonParse strategy = JsonParse::STANDARD) {
@@ -206,8 +230,25 @@ public:
 
 private:
     std::shared_ptr<JsonValue> m_ptr;
+
+    // Updates the allocation counters ( if enabled ) after the construction of a node
+    void track_alloc() const;
 };
 
+/* Optional allocation counters of the JsonValue nodes by type. The counters are global ( updated atomically,
+ * thus the parser can be called from multiple threads ) and they are updated only while the tracking is
+ * enabled. The bytes are an estimate of the heap memory of each node ( the node, the shared_ptr control block
+ * and the heap buffers of the strings, arrays and objects ). The null and boolean values are shared statics.
+ */
+enum AllocNode {
+    ALLOC_DOUBLE, ALLOC_INT, ALLOC_STRING, ALLOC_ARRAY, ALLOC_OBJECT, ALLOC_NODE_TYPES
+};
+
+void set_alloc_tracking(bool enable);
+bool alloc_tracking();
+void alloc_stats(unsigned long long counts[ALLOC_NODE_TYPES], unsigned long long bytes[ALLOC_NODE_TYPES]);
+void reset_alloc_stats();
+
 // Internal class hierarchy - JsonValue objects are not exposed to users of this API.
 class JsonValue {
 protected:
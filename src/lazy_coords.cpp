@@ -0,0 +1,222 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file lazy_coords.cpp
+ *
+ * @Notes: ALTREP real-vector class for the coordinate matrices of the 'FROM_GeoJson' functions. The coordinates
+ *         stay in a C++ buffer and are copied to R memory only when the object is written to ( writeable DATAPTR )
+ *
+ **/
+
+
+# include <RcppArmadillo.h>
+// [[Rcpp::depends("RcppArmadillo")]]
+// [[Rcpp::plugins(cpp11)]]
+
+
+#include <vector>
+#include <algorithm>
+
+#include <R.h>
+#include <Rinternals.h>
+#include <Rversion.h>
+#include <R_ext/Rdynload.h>
+
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 6, 0)
+#define GEOJSONR_ALTREP
+#include <R_ext/Altrep.h>
+#endif
+
+#include "lazy_coords.h"
+
+
+
+#ifdef GEOJSONR_ALTREP
+
+
+static R_altrep_class_t lazy_coords_class;
+
+
+// data1 : external pointer to the C++ buffer, data2 : the materialized REALSXP (R_NilValue as long as it is not materialized)
+//
+
+static std::vector<double> *lazy_coords_buffer(SEXP x) {
+
+  return static_cast<std::vector<double> *>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+
+static void lazy_coords_finalizer(SEXP xptr) {
+
+  std::vector<double> *buf = static_cast<std::vector<double> *>(R_ExternalPtrAddr(xptr));
+
+  delete buf;
+
+  R_ClearExternalPtr(xptr);
+}
+
+
+// copy the C++ buffer to R memory [ once ]. The buffer is kept, because read-only pointers to it might still be in use
+//
+
+static SEXP lazy_coords_materialize(SEXP x) {
+
+  SEXP mat = R_altrep_data2(x);
+
+  if (mat == R_NilValue) {
+
+    std::vector<double> *buf = lazy_coords_buffer(x);
+
+    mat = PROTECT(Rf_allocVector(REALSXP, buf->size()));
+
+    std::copy(buf->begin(), buf->end(), REAL(mat));
+
+    R_set_altrep_data2(x, mat);
+
+    UNPROTECT(1);
+  }
+
+  return mat;
+}
+
+
+static R_xlen_t lazy_coords_Length(SEXP x) {
+
+  SEXP mat = R_altrep_data2(x);
+
+  return (mat == R_NilValue) ? static_cast<R_xlen_t>(lazy_coords_buffer(x)->size()) : XLENGTH(mat);
+}
+
+
+static Rboolean lazy_coords_Inspect(SEXP x, int pre, int deep, int pvec, void (*inspect_subtree)(SEXP, int, int, int)) {
+
+  Rprintf("geojsonR::lazy_coords (len=%lld, materialized=%s)\n", static_cast<long long>(lazy_coords_Length(x)), (R_altrep_data2(x) == R_NilValue) ? "F" : "T");
+
+  return TRUE;
+}
+
+
+static void *lazy_coords_Dataptr(SEXP x, Rboolean writeable) {
+
+  SEXP mat = R_altrep_data2(x);
+
+  if (mat != R_NilValue) {
+
+    return REAL(mat);
+  }
+
+  std::vector<double> *buf = lazy_coords_buffer(x);
+
+  if (writeable || buf->empty()) {                                    // a write access ( or an empty buffer ) materializes the object
+
+    return REAL(lazy_coords_materialize(x));
+  }
+
+  return buf->data();                                                 // read-only access points directly into the C++ buffer
+}
+
+
+static const void *lazy_coords_Dataptr_or_null(SEXP x) {
+
+  SEXP mat = R_altrep_data2(x);
+
+  if (mat != R_NilValue) {
+
+    return REAL(mat);
+  }
+
+  std::vector<double> *buf = lazy_coords_buffer(x);
+
+  return buf->empty() ? NULL : buf->data();
+}
+
+
+static double lazy_coords_Elt(SEXP x, R_xlen_t i) {
+
+  SEXP mat = R_altrep_data2(x);
+
+  return (mat == R_NilValue) ? (*lazy_coords_buffer(x))[i] : REAL(mat)[i];
+}
+
+
+static R_xlen_t lazy_coords_Get_region(SEXP x, R_xlen_t i, R_xlen_t n, double *out) {
+
+  R_xlen_t len = lazy_coords_Length(x);
+
+  if (i < 0 || i >= len || n <= 0) return 0;                                          // the region is outside of the vector
+
+  R_xlen_t ncopy = (len - i > n) ? n : len - i;
+
+  SEXP mat = R_altrep_data2(x);
+
+  const double *src = (mat == R_NilValue) ? lazy_coords_buffer(x)->data() : REAL(mat);
+
+  std::copy(src + i, src + i + ncopy, out);
+
+  return ncopy;
+}
+
+
+#endif
+
+
+
+SEXP lazy_coords_matrix(std::vector<double> &&coords, int nrow, int ncol) {
+
+#ifdef GEOJSONR_ALTREP
+
+  std::vector<double> *buf = new std::vector<double>(std::move(coords));
+
+  SEXP xptr = PROTECT(R_MakeExternalPtr(buf, R_NilValue, R_NilValue));
+
+  R_RegisterCFinalizerEx(xptr, lazy_coords_finalizer, TRUE);
+
+  SEXP res = PROTECT(R_new_altrep(lazy_coords_class, xptr, R_NilValue));
+
+  SEXP dims = PROTECT(Rf_allocVector(INTSXP, 2));
+
+  INTEGER(dims)[0] = nrow;
+
+  INTEGER(dims)[1] = ncol;
+
+  Rf_setAttrib(res, R_DimSymbol, dims);
+
+  UNPROTECT(3);
+
+  return res;
+
+#else
+
+  Rcpp::NumericMatrix res(nrow, ncol, coords.begin());
+
+  return res;
+
+#endif
+}
+
+
+
+// registration of the ALTREP class [ called from 'R_init_geojsonR' in 'init.c' ]
+//
+
+extern "C" void geojsonR_init_altrep(DllInfo *dll) {
+
+#ifdef GEOJSONR_ALTREP
+
+  lazy_coords_class = R_make_altreal_class("lazy_coords", "geojsonR", dll);
+
+  R_set_altrep_Length_method(lazy_coords_class, lazy_coords_Length);
+
+  R_set_altrep_Inspect_method(lazy_coords_class, lazy_coords_Inspect);
+
+  R_set_altvec_Dataptr_method(lazy_coords_class, lazy_coords_Dataptr);
+
+  R_set_altvec_Dataptr_or_null_method(lazy_coords_class, lazy_coords_Dataptr_or_null);
+
+  R_set_altreal_Elt_method(lazy_coords_class, lazy_coords_Elt);
+
+  R_set_altreal_Get_region_method(lazy_coords_class, lazy_coords_Get_region);
+
+#endif
+}
@@ -0,0 +1,23 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file lazy_coords.h
+ *
+ * @Notes: ALTREP-backed (lazy) coordinate matrices [ see 'lazy_coords.cpp' ]
+ *
+ **/
+
+
+#pragma once
+
+#include <vector>
+
+#include <Rinternals.h>
+
+
+// returns a numeric matrix ( 'nrow' x 'ncol', column-major 'coords' ) which points to the retained C++ buffer
+// and is copied to R memory only if it is modified [ falls back to a regular numeric matrix if ALTREP is not available, R < 3.6.0 ]
+//
+
+SEXP lazy_coords_matrix(std::vector<double> &&coords, int nrow, int ncol);
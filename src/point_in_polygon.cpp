@@ -0,0 +1,470 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file point_in_polygon.cpp
+ *
+ * @Notes: batch point-in-polygon of an M x 2 matrix of points against a layer of 'Polygon' / 'MultiPolygon' features. The layer is copied to flat
+ *         coordinate buffers, the candidate features are filtered using a uniform grid of the feature bounding boxes and each candidate is tested
+ *         using the crossing-number ( even-odd ) rule
+ *
+ **/
+
+
+# include <RcppArmadillo.h>
+// [[Rcpp::depends("RcppArmadillo")]]
+// [[Rcpp::plugins(cpp11)]]
+
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+
+// Class for the flat polygon layer
+//
+// the coordinates of all rings are stored in the 'xs' and 'ys' vectors ( every ring is closed ). A polygon is a range of rings and a feature a range of polygons
+//
+
+class Polygon_Layer {
+
+private:
+
+  std::vector<double> xs, ys;
+
+  std::vector<int> ring_start, ring_size;                  // each ring 'r' includes the positions [ ring_start[r], ring_start[r] + ring_size[r] )
+
+  std::vector<int> poly_first_ring, poly_num_rings;
+
+  std::vector<int> feat_first_poly, feat_num_polys;
+
+  std::vector<double> feat_bbox;                           // 4 values per feature ( xmin, ymin, xmax, ymax )
+
+  std::vector<int> feat_value;                             // the value that is returned for each feature
+
+  double grid_xmin, grid_ymin, cell_w, cell_h;
+
+  int grid_nx, grid_ny;
+
+  std::vector<int> cell_start, cell_items;                 // compressed lists of the candidate features of each grid-cell [ in increasing order ]
+
+
+  // even-odd test of a point against all rings of a polygon ( the edges are consecutive positions, the loop is branch-free so that it can be vectorized )
+  //
+
+  bool inside_polygon(int poly, double px, double py) const {
+
+    int crossings = 0;
+
+    int last_ring = poly_first_ring[poly] + poly_num_rings[poly];
+
+    for (int r = poly_first_ring[poly]; r < last_ring; r++) {
+
+      const double *x = &xs[ring_start[r]];
+
+      const double *y = &ys[ring_start[r]];
+
+      int num_edges = ring_size[r] - 1;
+
+      #ifdef _OPENMP
+      #pragma omp simd reduction(+:crossings)
+      #endif
+      for (int i = 0; i < num_edges; i++) {
+
+        double x0 = x[i], y0 = y[i], x1 = x[i + 1], y1 = y[i + 1];
+
+        int straddles = (y0 > py) != (y1 > py);
+
+        double x_cross = x0 + (py - y0) * (x1 - x0) / (y1 - y0);            // not used ( NaN / Inf ) if the edge does not straddle the horizontal line of the point
+
+        crossings += straddles & (px < x_cross);
+      }
+    }
+
+    return crossings & 1;
+  }
+
+
+public:
+
+  Polygon_Layer() : grid_xmin(0.0), grid_ymin(0.0), cell_w(1.0), cell_h(1.0), grid_nx(0), grid_ny(0) { }
+
+
+  // starts a new feature
+  //
+
+  void begin_feature(int value) {
+
+    feat_first_poly.push_back(poly_first_ring.size());
+
+    feat_num_polys.push_back(0);
+
+    feat_value.push_back(value);
+
+    double inf = std::numeric_limits<double>::infinity();
+
+    feat_bbox.insert(feat_bbox.end(), {inf, inf, -inf, -inf});
+  }
+
+
+  // starts a new polygon of the current feature
+  //
+
+  void begin_polygon() {
+
+    poly_first_ring.push_back(ring_start.size());
+
+    poly_num_rings.push_back(0);
+
+    feat_num_polys.back()++;
+  }
+
+
+  // adds a ring ( 'n' positions ) to the current polygon [ the ring is closed if the first and last position differ ]
+  //
+
+  void add_ring(const double *x, const double *y, int n) {
+
+    if (n < 3) return;                                     // degenerate ring
+
+    double *bx = &feat_bbox[feat_bbox.size() - 4];
+
+    for (int i = 0; i < n; i++) {
+
+      bx[0] = std::min(bx[0], x[i]); bx[1] = std::min(bx[1], y[i]);
+
+      bx[2] = std::max(bx[2], x[i]); bx[3] = std::max(bx[3], y[i]);
+    }
+
+    ring_start.push_back(xs.size());
+
+    xs.insert(xs.end(), x, x + n);
+
+    ys.insert(ys.end(), y, y + n);
+
+    if (x[0] != x[n - 1] || y[0] != y[n - 1]) {
+
+      xs.push_back(x[0]);
+
+      ys.push_back(y[0]);
+
+      n++;
+    }
+
+    ring_size.push_back(n);
+
+    poly_num_rings.back()++;
+  }
+
+
+  // uniform grid of the feature bounding boxes ( approx. 'cells_per_feature' cells per feature )
+  //
+
+  void build_grid(double cells_per_feature = 1.0) {
+
+    int num_feat = feat_value.size();
+
+    double inf = std::numeric_limits<double>::infinity();
+
+    double xmin = inf, ymin = inf, xmax = -inf, ymax = -inf;
+
+    for (int f = 0; f < num_feat; f++) {
+
+      if (feat_bbox[4 * f] > feat_bbox[4 * f + 2]) continue;                      // feature without rings
+
+      xmin = std::min(xmin, feat_bbox[4 * f]); ymin = std::min(ymin, feat_bbox[4 * f + 1]);
+
+      xmax = std::max(xmax, feat_bbox[4 * f + 2]); ymax = std::max(ymax, feat_bbox[4 * f + 3]);
+    }
+
+    if (xmin > xmax) {                                                              // empty layer
+
+      grid_nx = grid_ny = 0;
+
+      return;
+    }
+
+    int side = std::max(1, std::min(1024, static_cast<int>(std::ceil(std::sqrt(num_feat * cells_per_feature)))));
+
+    grid_nx = grid_ny = side;
+
+    grid_xmin = xmin; grid_ymin = ymin;
+
+    cell_w = (xmax > xmin) ? (xmax - xmin) / grid_nx : 1.0;
+
+    cell_h = (ymax > ymin) ? (ymax - ymin) / grid_ny : 1.0;
+
+    std::vector<int> counts(grid_nx * grid_ny + 1, 0);
+
+    for (int pass = 0; pass < 2; pass++) {                                         // first pass: counts, second pass: fill
+
+      std::vector<int> fill_pos;
+
+      if (pass == 1) {
+
+        cell_start.assign(counts.size(), 0);
+
+        for (int c = 0; c < grid_nx * grid_ny; c++) {
+
+          cell_start[c + 1] = cell_start[c] + counts[c];
+        }
+
+        cell_items.resize(cell_start.back());
+
+        fill_pos.assign(cell_start.begin(), cell_start.end() - 1);
+      }
+
+      for (int f = 0; f < num_feat; f++) {
+
+        if (feat_bbox[4 * f] > feat_bbox[4 * f + 2]) continue;
+
+        int cx0 = cell_x(feat_bbox[4 * f]), cy0 = cell_y(feat_bbox[4 * f + 1]), cx1 = cell_x(feat_bbox[4 * f + 2]), cy1 = cell_y(feat_bbox[4 * f + 3]);
+
+        for (int cy = cy0; cy <= cy1; cy++) {
+
+          for (int cx = cx0; cx <= cx1; cx++) {
+
+            if (pass == 0) {
+
+              counts[cy * grid_nx + cx]++;}
+
+            else {
+
+              cell_items[fill_pos[cy * grid_nx + cx]++] = f;
+            }
+          }
+        }
+      }
+    }
+  }
+
+
+  int cell_x(double x) const {
+
+    return std::max(0, std::min(grid_nx - 1, static_cast<int>(std::floor((x - grid_xmin) / cell_w))));
+  }
+
+
+  int cell_y(double y) const {
+
+    return std::max(0, std::min(grid_ny - 1, static_cast<int>(std::floor((y - grid_ymin) / cell_h))));
+  }
+
+
+  // the value of the first feature ( in the input order ) that includes the point, otherwise NA
+  //
+
+  int locate(double px, double py) const {
+
+    if (grid_nx == 0 || std::isnan(px) || std::isnan(py)) return NA_INTEGER;
+
+    if (px < grid_xmin || py < grid_ymin || px > grid_xmin + cell_w * grid_nx || py > grid_ymin + cell_h * grid_ny) return NA_INTEGER;
+
+    int cell = cell_y(py) * grid_nx + cell_x(px);
+
+    for (int k = cell_start[cell]; k < cell_start[cell + 1]; k++) {
+
+      int f = cell_items[k];
+
+      const double *bx = &feat_bbox[4 * f];
+
+      if (px < bx[0] || px > bx[2] || py < bx[1] || py > bx[3]) continue;
+
+      int last_poly = feat_first_poly[f] + feat_num_polys[f];
+
+      for (int p = feat_first_poly[f]; p < last_poly; p++) {
+
+        if (inside_polygon(p, px, py)) return feat_value[f];
+      }
+    }
+
+    return NA_INTEGER;
+  }
+
+
+  ~Polygon_Layer() { }
+};
+
+
+
+// adds all (nested) coordinate matrices of 'obj' as rings of the current polygon
+//
+
+void add_nested_rings(Polygon_Layer &layer, SEXP obj) {
+
+  if (Rf_isMatrix(obj) && TYPEOF(obj) == REALSXP) {
+
+    Rcpp::NumericMatrix ring(obj);
+
+    if (ring.ncol() < 2) Rcpp::stop("the coordinate matrices of the polygons should have at least 2 columns!");
+
+    layer.add_ring(ring.begin(), ring.begin() + ring.nrow(), ring.nrow());
+  }
+
+  else if (TYPEOF(obj) == VECSXP) {
+
+    for (R_xlen_t i = 0; i < Rf_xlength(obj); i++) {
+
+      add_nested_rings(layer, VECTOR_ELT(obj, i));
+    }
+  }
+
+  else {
+
+    Rcpp::stop("the coordinates of the polygons should be numeric matrices ( use 'To_List' = FALSE in the 'FROM_GeoJson' function )!");
+  }
+}
+
+
+// adds a 'Polygon' or 'MultiPolygon' geometry ( as returned from the 'FROM_GeoJson' function ) to the current feature [ other geometries are ignored ]
+//
+
+void add_geometry(Polygon_Layer &layer, Rcpp::List geom) {
+
+  if (!geom.containsElementNamed("type") || !geom.containsElementNamed("coordinates")) return;
+
+  std::string geom_type = Rcpp::as<std::string>(geom["type"]);
+
+  SEXP coords = geom["coordinates"];
+
+  if (geom_type == "Polygon") {
+
+    layer.begin_polygon();
+
+    add_nested_rings(layer, coords);
+  }
+
+  else if (geom_type == "MultiPolygon") {
+
+    if (TYPEOF(coords) != VECSXP) Rcpp::stop("the coordinates of a 'MultiPolygon' should be a list!");
+
+    for (R_xlen_t i = 0; i < Rf_xlength(coords); i++) {
+
+      layer.begin_polygon();                                          // each item is a polygon ( a matrix or a list of rings )
+
+      add_nested_rings(layer, VECTOR_ELT(coords, i));
+    }
+  }
+}
+
+
+
+// locates all points ( M x 2 matrix ) in parallel [ 'locate' does not use the R API ]
+//
+
+Rcpp::IntegerVector locate_points(const Polygon_Layer &layer, Rcpp::NumericMatrix points, int threads) {
+
+  if (points.ncol() != 2) Rcpp::stop("the 'points' should be a numeric matrix of 2 columns!");
+
+  int num_points = points.nrow();
+
+  const double *px = points.begin(), *py = points.begin() + num_points;
+
+  std::vector<int> res(num_points);
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  #endif
+  for (int i = 0; i < num_points; i++) {
+
+    res[i] = layer.locate(px[i], py[i]);
+  }
+
+  return Rcpp::wrap(res);
+}
+
+
+
+//========================
+// Rcpp-exported functions
+//========================
+
+
+// point-in-polygon against a list of features ( or geometries ). The output is the ( 1-based ) index of the containing feature or NA
+//
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector export_point_in_polygon(Rcpp::NumericMatrix points, Rcpp::List features, int threads = 1) {
+
+  Polygon_Layer layer;
+
+  for (int f = 0; f < features.size(); f++) {
+
+    layer.begin_feature(f + 1);
+
+    SEXP item = features[f];
+
+    if (TYPEOF(item) != VECSXP) continue;
+
+    Rcpp::List feat(item);
+
+    if (feat.containsElementNamed("geometry")) {
+
+      SEXP geom = feat["geometry"];
+
+      if (TYPEOF(geom) == VECSXP) add_geometry(layer, Rcpp::List(geom));}
+
+    else {
+
+      add_geometry(layer, feat);
+    }
+  }
+
+  layer.build_grid();
+
+  return locate_points(layer, points, threads);
+}
+
+
+// point-in-polygon against a flat coordinate buffer, i.e. a numeric matrix with the columns ( feature_id, part_id, ring_id, x, y ) which is sorted by
+// feature, part and ring. The output is the 'feature_id' of the containing feature or NA
+//
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector export_point_in_polygon_flat(Rcpp::NumericMatrix points, Rcpp::NumericMatrix coords, int threads = 1) {
+
+  Polygon_Layer layer;
+
+  if (coords.ncol() != 5) Rcpp::stop("the flat coordinate buffer should be a numeric matrix of 5 columns ( feature_id, part_id, ring_id, x, y )!");
+
+  int n = coords.nrow();
+
+  const double *fid = coords.begin(), *pid = fid + n, *rid = pid + n, *x = rid + n, *y = x + n;
+
+  int start = 0;
+
+  for (int i = 1; i <= n && n > 0; i++) {
+
+    bool new_feature = (i == n) || fid[i] != fid[start];
+
+    bool new_part = new_feature || pid[i] != pid[start];
+
+    bool new_ring = new_part || rid[i] != rid[start];
+
+    if (!new_ring) continue;
+
+    if (start == 0 || fid[start] != fid[start - 1]) {
+
+      layer.begin_feature(static_cast<int>(fid[start]));
+    }
+
+    if (start == 0 || fid[start] != fid[start - 1] || pid[start] != pid[start - 1]) {
+
+      layer.begin_polygon();
+    }
+
+    layer.add_ring(x + start, y + start, i - start);
+
+    start = i;
+  }
+
+  layer.build_grid();
+
+  return locate_points(layer, points, threads);
+}
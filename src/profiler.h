@@ -0,0 +1,212 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file profiler.h
+ *
+ * @Notes: opt-in instrumentation of the exported functions ( 'profile = TRUE' ). The wall time ( arma::wall_clock ) and the processed bytes are accumulated for
+ *         each phase ( file read, JSON parse, R conversion, serialization, write ) and the nodes of the parsed json11 objects are counted by type. If the profiler
+ *         is disabled then all methods return immediately, thus the instrumented code does not require any if-conditions
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "json11.h"
+
+
+class Phase_Profiler {
+
+private:
+
+  bool enabled;
+
+  arma::wall_clock timer;
+
+  std::vector<std::string> phases;                          // in the order of the first 'start()' of each phase
+
+  std::vector<double> seconds, bytes;
+
+  int current;                                              // index of the running phase ( -1 : none )
+
+  double json_nodes[6];                                     // null, boolean, number, string, array, object
+
+  bool has_json_nodes;
+
+
+  int phase_index(const std::string &phase) {
+
+    for (size_t i = 0; i < phases.size(); i++) {
+
+      if (phases[i] == phase) return i;
+    }
+
+    phases.push_back(phase);
+
+    seconds.push_back(0.0);
+
+    bytes.push_back(0.0);
+
+    return phases.size() - 1;
+  }
+
+
+  void count_nodes(const json11::Json &node) {
+
+    switch (node.type()) {
+
+      case json11::Json::NUL: json_nodes[0]++; break;
+
+      case json11::Json::BOOL: json_nodes[1]++; break;
+
+      case json11::Json::NUMBER: json_nodes[2]++; break;
+
+      case json11::Json::STRING: json_nodes[3]++; break;
+
+      case json11::Json::ARRAY: {
+
+        json_nodes[4]++;
+
+        for (auto &item : node.array_items()) count_nodes(item);
+
+        break;
+      }
+
+      case json11::Json::OBJECT: {
+
+        json_nodes[5]++;
+
+        for (auto &item : node.object_items()) count_nodes(item.second);
+
+        break;
+      }
+    }
+  }
+
+public:
+
+  Phase_Profiler(bool enabled_ = false) : enabled(enabled_), current(-1), has_json_nodes(false) {
+
+    std::fill(json_nodes, json_nodes + 6, 0.0);
+  }
+
+
+  void set_enabled(bool enabled_) { enabled = enabled_; }
+
+
+  bool is_enabled() const { return enabled; }
+
+
+  // starts ( or resumes ) a phase, the running phase is stopped. The time of a phase which is started many times ( for instance once per file ) is accumulated
+  //
+
+  void start(const std::string &phase) {
+
+    if (!enabled) return;
+
+    stop();
+
+    current = phase_index(phase);
+
+    timer.tic();
+  }
+
+
+  // stops the running phase and adds the 'processed_bytes' to it
+  //
+
+  void stop(double processed_bytes = 0.0) {
+
+    if (!enabled || current < 0) return;
+
+    seconds[current] += timer.toc();
+
+    bytes[current] += processed_bytes;
+
+    current = -1;
+  }
+
+
+  // adds the time and the bytes of a phase which was timed separately ( for instance in a different thread )
+  //
+
+  void add(const std::string &phase, double elapsed_seconds, double processed_bytes) {
+
+    if (!enabled) return;
+
+    int idx = phase_index(phase);
+
+    seconds[idx] += elapsed_seconds;
+
+    bytes[idx] += processed_bytes;
+  }
+
+
+  // counts the nodes of a parsed json object by type ( the time of the count is not included in any phase )
+  //
+
+  void count_json_nodes(const json11::Json &parsed) {
+
+    if (!enabled) return;
+
+    bool running = current >= 0;
+
+    std::string running_phase = running ? phases[current] : "";
+
+    stop();
+
+    count_nodes(parsed);
+
+    has_json_nodes = true;
+
+    if (running) start(running_phase);
+  }
+
+
+  // list of a data.frame of the phases ( 'phase', 'seconds', 'bytes' ) and of the counts of the json nodes ( if any json data were parsed )
+  //
+
+  Rcpp::List summary() {
+
+    stop();
+
+    Rcpp::DataFrame phases_df = Rcpp::DataFrame::create(Rcpp::Named("phase") = phases, Rcpp::Named("seconds") = seconds,
+
+                                                        Rcpp::Named("bytes") = bytes, Rcpp::Named("stringsAsFactors") = false);
+
+    Rcpp::List res = Rcpp::List::create(Rcpp::Named("phases") = phases_df);
+
+    if (has_json_nodes) {
+
+      Rcpp::NumericVector nodes(json_nodes, json_nodes + 6);
+
+      nodes.names() = Rcpp::CharacterVector::create("null", "boolean", "number", "string", "array", "object");
+
+      res["json_nodes"] = nodes;
+    }
+
+    return res;
+  }
+
+
+  // attaches the summary as the "profile" attribute of the output
+  //
+
+  SEXP attach(SEXP output) {
+
+    if (!enabled) return output;
+
+    Rcpp::RObject res(output);
+
+    res.attr("profile") = summary();
+
+    return res;
+  }
+
+  ~Phase_Profiler() { }
+};
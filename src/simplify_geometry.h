@@ -0,0 +1,584 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file simplify_geometry.h
+ *
+ * @Notes: Douglas-Peucker simplification of positions ( used in the 'FROM_geojson.cpp' and 'TO_geojson.cpp' files )
+ *
+ **/
+
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+// distance of the point (px, py) from the segment (ax, ay) - (bx, by)
+//
+
+inline double segment_distance(double px, double py, double ax, double ay, double bx, double by) {
+
+  double dx = bx - ax, dy = by - ay;
+
+  double len2 = dx * dx + dy * dy;
+
+  double t = (len2 > 0.0) ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0;
+
+  t = std::max(0.0, std::min(1.0, t));
+
+  double ex = ax + t * dx - px, ey = ay + t * dy - py;
+
+  return std::sqrt(ex * ex + ey * ey);
+}
+
+
+// significance of each position in the Douglas-Peucker order [ the distance at which the position is selected, which is bounded by the significance of
+// the positions that split the range, thus removing all positions with significance <= 'tolerance' gives the Douglas-Peucker result ]. The range is split
+// using an explicit stack ( no recursion )
+//
+
+inline void douglas_peucker_significance(const double *x, const double *y, int first, int last, double upper, std::vector<double> &sig) {
+
+  std::vector<std::pair<std::pair<int, int>, double> > stack;
+
+  stack.push_back(std::make_pair(std::make_pair(first, last), upper));
+
+  while (!stack.empty()) {
+
+    int a = stack.back().first.first, b = stack.back().first.second;
+
+    double bound = stack.back().second;
+
+    stack.pop_back();
+
+    if (b - a < 2) continue;
+
+    int idx_max = a + 1;
+
+    double dist_max = -1.0;
+
+    for (int i = a + 1; i < b; i++) {
+
+      double d = segment_distance(x[i], y[i], x[a], y[a], x[b], y[b]);
+
+      if (d > dist_max) {
+
+        dist_max = d;
+
+        idx_max = i;
+      }
+    }
+
+    double s = std::min(dist_max, bound);
+
+    sig[idx_max] = s;
+
+    stack.push_back(std::make_pair(std::make_pair(a, idx_max), s));
+
+    stack.push_back(std::make_pair(std::make_pair(idx_max, b), s));
+  }
+}
+
+
+// positions of a LineString or of a ring during the simplification [ 'sig' is the Douglas-Peucker significance and 'keep' the indices of the kept positions ]
+//
+
+struct Simplify_Ring {
+
+  const double *x, *y;
+
+  int n;
+
+  bool closed;                                                        // closed ring ( the first and the last positions are equal ), otherwise a LineString
+
+  std::vector<double> sig;
+
+  std::vector<char> kept;
+
+  std::vector<int> keep;
+
+  void update_keep() {
+
+    keep.clear();
+
+    for (int i = 0; i < n; i++) {
+
+      if (kept[i]) keep.push_back(i);
+    }
+  }
+};
+
+
+// Douglas-Peucker simplification of a LineString ( at least 2 positions ) or of a closed ring ( at least 4 positions, including the closing position ). A ring is
+// split at the position which is farthest from the first one, so that both halves are simplified as LineStrings
+//
+
+inline void simplify_ring_init(Simplify_Ring &r, const double *x, const double *y, int n, double tolerance, bool ring) {
+
+  r.x = x; r.y = y; r.n = n;
+
+  r.closed = ring && n >= 4 && x[0] == x[n - 1] && y[0] == y[n - 1];
+
+  int min_positions = r.closed ? 4 : 2;
+
+  double inf = std::numeric_limits<double>::infinity();
+
+  r.kept.assign(n, 1);
+
+  if (tolerance <= 0.0 || n <= min_positions) {
+
+    r.sig.assign(n, inf);
+
+    r.update_keep();
+
+    return;
+  }
+
+  r.sig.assign(n, 0.0);
+
+  std::vector<double> &sig = r.sig;
+
+  sig[0] = sig[n - 1] = inf;
+
+  if (r.closed) {
+
+    int idx_far = 1;
+
+    double dist_far = -1.0;
+
+    for (int i = 1; i < n - 1; i++) {
+
+      double d = std::hypot(x[i] - x[0], y[i] - y[0]);
+
+      if (d > dist_far) {
+
+        dist_far = d;
+
+        idx_far = i;
+      }
+    }
+
+    sig[idx_far] = inf;
+
+    douglas_peucker_significance(x, y, 0, idx_far, inf, sig);
+
+    douglas_peucker_significance(x, y, idx_far, n - 1, inf, sig);
+  }
+
+  else {
+
+    douglas_peucker_significance(x, y, 0, n - 1, inf, sig);
+  }
+
+  int num_kept = 0;
+
+  for (int i = 0; i < n; i++) {
+
+    r.kept[i] = sig[i] > tolerance;
+
+    num_kept += r.kept[i];
+  }
+
+  if (num_kept < min_positions) {                                     // keep the most significant positions so that the minimum number of positions is retained
+
+    std::vector<int> order(n);
+
+    for (int i = 0; i < n; i++) order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&sig](int a, int b) { return sig[a] > sig[b]; });
+
+    for (int k = 0; num_kept < min_positions && k < n; k++) {
+
+      if (!r.kept[order[k]]) {
+
+        r.kept[order[k]] = 1;
+
+        num_kept++;
+      }
+    }
+  }
+
+  r.update_keep();
+}
+
+
+// re-adds the most significant dropped position between the positions 'first' and 'last' ( exclusive ) [ false if all positions of the range are kept ]
+//
+
+inline bool simplify_ring_restore(Simplify_Ring &r, int first, int last) {
+
+  int idx_max = -1;
+
+  for (int i = first + 1; i < last; i++) {
+
+    if (!r.kept[i] && (idx_max < 0 || r.sig[i] > r.sig[idx_max])) idx_max = i;
+  }
+
+  if (idx_max < 0) return false;
+
+  r.kept[idx_max] = 1;
+
+  return true;
+}
+
+
+// orientation of the triangle (a, b, c) [ > 0 : counter-clockwise, < 0 : clockwise, 0 : collinear ]
+//
+
+inline double orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+
+  return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+
+// true if the collinear point (px, py) lies on the segment (ax, ay) - (bx, by)
+//
+
+inline bool on_segment(double px, double py, double ax, double ay, double bx, double by) {
+
+  return std::min(ax, bx) <= px && px <= std::max(ax, bx) && std::min(ay, by) <= py && py <= std::max(ay, by);
+}
+
+
+// true if the segments (a, b) and (c, d) cross or touch
+//
+
+inline bool segments_intersect(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+
+  double o1 = orientation(ax, ay, bx, by, cx, cy), o2 = orientation(ax, ay, bx, by, dx, dy);
+
+  double o3 = orientation(cx, cy, dx, dy, ax, ay), o4 = orientation(cx, cy, dx, dy, bx, by);
+
+  if (((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) && ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0))) return true;
+
+  return (o1 == 0.0 && on_segment(cx, cy, ax, ay, bx, by)) || (o2 == 0.0 && on_segment(dx, dy, ax, ay, bx, by)) ||
+
+         (o3 == 0.0 && on_segment(ax, ay, cx, cy, dx, dy)) || (o4 == 0.0 && on_segment(bx, by, cx, cy, dx, dy));
+}
+
+
+// true if the point (px, py) is inside the ring formed by the positions 'idx' ( ray casting )
+//
+
+inline bool point_in_ring(double px, double py, const double *x, const double *y, const std::vector<int> &idx) {
+
+  bool inside = false;
+
+  for (size_t i = 0, j = idx.size() - 1; i < idx.size(); j = i++) {
+
+    double xi = x[idx[i]], yi = y[idx[i]], xj = x[idx[j]], yj = y[idx[j]];
+
+    if ((yi > py) != (yj > py) && px < (xj - xi) * (py - yi) / (yj - yi) + xi) inside = !inside;
+  }
+
+  return inside;
+}
+
+
+// segment between the kept positions 'seg' and 'seg + 1' of a ring [ bounding box for the sweep over the x axis ]
+//
+
+struct Simplify_Segment {
+
+  double xmin, xmax, ymin, ymax;
+
+  int ring, seg;
+};
+
+
+// true if two segments of the kept positions intersect, apart from the shared end-position of consecutive segments of the same ring [ which are invalid
+// only if they overlap, i.e. the ring turns back on itself ]
+//
+
+inline bool segments_conflict(const std::vector<Simplify_Ring> &rings, const Simplify_Segment &s1, const Simplify_Segment &s2) {
+
+  const Simplify_Ring &r1 = rings[s1.ring], &r2 = rings[s2.ring];
+
+  int a = r1.keep[s1.seg], b = r1.keep[s1.seg + 1], c = r2.keep[s2.seg], d = r2.keep[s2.seg + 1];
+
+  if (s1.ring == s2.ring) {
+
+    int num_segs = r1.keep.size() - 1;
+
+    int lo = std::min(s1.seg, s2.seg), hi = std::max(s1.seg, s2.seg);
+
+    if (hi - lo == 1 || (lo == 0 && hi == num_segs - 1)) {
+
+      int p, q, shared;                                              // 'p' - 'shared' - 'q'
+
+      if (hi - lo == 1) {
+
+        shared = r1.keep[hi]; p = r1.keep[lo]; q = r1.keep[hi + 1];}
+
+      else {
+
+        shared = r1.keep[0]; p = r1.keep[1]; q = r1.keep[num_segs - 1];
+      }
+
+      const double *x = r1.x, *y = r1.y;
+
+      return orientation(x[p], y[p], x[shared], y[shared], x[q], y[q]) == 0.0 && (x[p] - x[shared]) * (x[q] - x[shared]) + (y[p] - y[shared]) * (y[q] - y[shared]) > 0.0;
+    }
+  }
+
+  return segments_intersect(r1.x[a], r1.y[a], r1.x[b], r1.y[b], r2.x[c], r2.y[c], r2.x[d], r2.y[d]);
+}
+
+
+// re-adds dropped positions until the kept positions of the closed rings form valid rings : the most significant dropped position of each segment which
+// intersects another segment is re-added ( if both segments were already part of the input, then the intersection exists in the input and it is ignored ).
+// If 'polygon' is TRUE then the first ring is the exterior ring and the interior rings, which are inside the input exterior ring, must remain inside the
+// simplified exterior ring
+//
+
+inline void simplify_rings_repair(std::vector<Simplify_Ring> &rings, bool polygon) {
+
+  std::vector<int> all_exterior;
+
+  if (polygon && !rings.empty() && rings[0].closed) {
+
+    all_exterior.resize(rings[0].n);
+
+    for (int i = 0; i < rings[0].n; i++) all_exterior[i] = i;
+  }
+
+  while (true) {
+
+    std::vector<Simplify_Segment> segs;
+
+    for (size_t k = 0; k < rings.size(); k++) {
+
+      const Simplify_Ring &r = rings[k];
+
+      if (!r.closed) continue;
+
+      for (size_t s = 0; s + 1 < r.keep.size(); s++) {
+
+        double ax = r.x[r.keep[s]], ay = r.y[r.keep[s]], bx = r.x[r.keep[s + 1]], by = r.y[r.keep[s + 1]];
+
+        Simplify_Segment seg = {std::min(ax, bx), std::max(ax, bx), std::min(ay, by), std::max(ay, by), static_cast<int>(k), static_cast<int>(s)};
+
+        segs.push_back(seg);
+      }
+    }
+
+    std::sort(segs.begin(), segs.end(), [](const Simplify_Segment &a, const Simplify_Segment &b) { return a.xmin < b.xmin; });
+
+    std::vector<std::pair<int, int> > restore;                        // (ring, segment)
+
+    for (size_t i = 0; i < segs.size(); i++) {
+
+      for (size_t j = i + 1; j < segs.size() && segs[j].xmin <= segs[i].xmax; j++) {
+
+        if (segs[j].ymin > segs[i].ymax || segs[j].ymax < segs[i].ymin) continue;
+
+        if (segments_conflict(rings, segs[i], segs[j])) {
+
+          restore.push_back(std::make_pair(segs[i].ring, segs[i].seg));
+
+          restore.push_back(std::make_pair(segs[j].ring, segs[j].seg));
+        }
+      }
+    }
+
+    std::sort(restore.begin(), restore.end());
+
+    restore.erase(std::unique(restore.begin(), restore.end()), restore.end());
+
+    bool restored = false;
+
+    for (auto &item : restore) {                                       // the ranges refer to the 'keep' vector of the start of the iteration
+
+      Simplify_Ring &r = rings[item.first];
+
+      restored = simplify_ring_restore(r, r.keep[item.second], r.keep[item.second + 1]) || restored;
+    }
+
+    if (!restored && !all_exterior.empty()) {
+
+      Simplify_Ring &exterior = rings[0];
+
+      for (size_t k = 1; k < rings.size() && !restored; k++) {
+
+        const Simplify_Ring &r = rings[k];
+
+        if (!r.closed) continue;
+
+        double px = r.x[r.keep[0]], py = r.y[r.keep[0]];
+
+        if (point_in_ring(px, py, exterior.x, exterior.y, all_exterior) && !point_in_ring(px, py, exterior.x, exterior.y, exterior.keep)) {
+
+          restored = simplify_ring_restore(exterior, 0, exterior.n - 1);
+        }
+      }
+    }
+
+    if (!restored) break;
+
+    for (auto &r : rings) r.update_keep();
+  }
+}
+
+
+// indices of the positions that are kept after the simplification of a LineString or of a ring [ see 'simplify_rings_repair()', a closed ring does not
+// intersect itself unless the input ring does ]
+//
+
+inline std::vector<int> simplify_positions(const double *x, const double *y, int n, double tolerance, bool ring) {
+
+  std::vector<Simplify_Ring> rings(1);
+
+  simplify_ring_init(rings[0], x, y, n, tolerance, ring);
+
+  if (rings[0].closed && static_cast<int>(rings[0].keep.size()) < n) simplify_rings_repair(rings, false);
+
+  return rings[0].keep;
+}
+
+
+// indices of the positions that are kept after the simplification of the rings of a Polygon ( the first ring is the exterior ring ). If the input is a
+// valid Polygon, then the simplified rings do not intersect themselves or each other and the interior rings remain inside the exterior ring. The kept
+// positions can include positions with significance lower than the 'tolerance'. The Polygons of a MultiPolygon are simplified independently, thus they
+// might overlap after the simplification
+//
+
+inline std::vector<std::vector<int> > simplify_polygon(const std::vector<const double *> &x, const std::vector<const double *> &y, const std::vector<int> &n, double tolerance) {
+
+  std::vector<Simplify_Ring> rings(n.size());
+
+  bool simplified = false;
+
+  for (size_t k = 0; k < n.size(); k++) {
+
+    simplify_ring_init(rings[k], x[k], y[k], n[k], tolerance, true);
+
+    simplified = simplified || (rings[k].closed && static_cast<int>(rings[k].keep.size()) < n[k]);
+  }
+
+  if (simplified) simplify_rings_repair(rings, true);
+
+  std::vector<std::vector<int> > keep(n.size());
+
+  for (size_t k = 0; k < n.size(); k++) keep[k].swap(rings[k].keep);
+
+  return keep;
+}
+
+
+// simplification of nested std::vectors [ 'TO_geojson.cpp' ]. A position is a std::vector<double> and the nesting level corresponds to the geometry-object
+//
+
+inline void simplify_nested(std::vector<double> &data, double tolerance, bool ring) { }                                  // 'Point'
+
+
+inline void simplify_nested(std::vector<std::vector<double> > &data, double tolerance, bool ring) {                     // 'LineString' or a ring
+
+  int n = data.size();
+
+  std::vector<double> x(n), y(n);
+
+  for (int i = 0; i < n; i++) {
+
+    if (data[i].size() < 2) return;                                                                                     // invalid position, the data are kept as they are
+
+    x[i] = data[i][0];
+
+    y[i] = data[i][1];
+  }
+
+  std::vector<int> keep = simplify_positions(x.data(), y.data(), n, tolerance, ring);
+
+  if (static_cast<int>(keep.size()) == n) return;
+
+  std::vector<std::vector<double> > out;
+
+  out.reserve(keep.size());
+
+  for (int idx : keep) {
+
+    out.push_back(std::move(data[idx]));
+  }
+
+  data.swap(out);
+}
+
+
+template<class T>
+inline void simplify_nested(std::vector<std::vector<T> > &data, double tolerance, bool ring) {                          // 'MultiLineString' [ the rings of polygons : 'simplify_rings()' ]
+
+  for (auto &item : data) {
+
+    simplify_nested(item, tolerance, ring);
+  }
+}
+
+
+// simplification of the rings of a 'Polygon' [ the rings are simplified together, see 'simplify_polygon()' ]
+//
+
+inline void simplify_rings(std::vector<std::vector<std::vector<double> > > &data, double tolerance) {
+
+  std::vector<std::vector<double> > xy(data.size());
+
+  std::vector<const double *> x(data.size()), y(data.size());
+
+  std::vector<int> n(data.size());
+
+  for (size_t k = 0; k < data.size(); k++) {
+
+    n[k] = data[k].size();
+
+    xy[k].resize(2 * n[k]);
+
+    for (int i = 0; i < n[k]; i++) {
+
+      if (data[k][i].size() < 2) return;                                                                                // invalid position, the data are kept as they are
+
+      xy[k][i] = data[k][i][0];
+
+      xy[k][n[k] + i] = data[k][i][1];
+    }
+
+    x[k] = xy[k].data();
+
+    y[k] = xy[k].data() + n[k];
+  }
+
+  std::vector<std::vector<int> > keep = simplify_polygon(x, y, n, tolerance);
+
+  for (size_t k = 0; k < data.size(); k++) {
+
+    if (static_cast<int>(keep[k].size()) == n[k]) continue;
+
+    std::vector<std::vector<double> > out;
+
+    out.reserve(keep[k].size());
+
+    for (int idx : keep[k]) {
+
+      out.push_back(std::move(data[k][idx]));
+    }
+
+    data[k].swap(out);
+  }
+}
+
+
+inline void simplify_rings(std::vector<std::vector<std::vector<std::vector<double> > > > &data, double tolerance) {               // 'MultiPolygon'
+
+  for (auto &item : data) {
+
+    simplify_rings(item, tolerance);
+  }
+}
+
+
+template<class T>
+inline void simplify_rings(T &data, double tolerance) {                                                                 // a single ring
+
+  simplify_nested(data, tolerance, true);
+}
@@ -0,0 +1,317 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file spatial_index.cpp
+ *
+ * @Notes: static packed R-tree ( Sort-Tile-Recursive ) over the bounding boxes of features. The tree is kept in C++ and it is returned to R as an external pointer
+ *
+ **/
+
+
+# include <RcppArmadillo.h>
+// [[Rcpp::depends("RcppArmadillo")]]
+// [[Rcpp::plugins(cpp11)]]
+
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+
+
+// Class for the packed R-tree
+//
+// every level of the tree is stored in flat vectors, where the level 0 includes the (sorted) bounding boxes of the features and each upper level the nodes which
+// cover a contiguous range of entries of the level below [ 'first_child', 'num_children' ]. The root is the single node of the last level
+//
+
+class Packed_RTree {
+
+private:
+
+  struct Level {
+
+    std::vector<double> boxes;                       // 4 values per entry ( xmin, ymin, xmax, ymax )
+
+    std::vector<int> first_child;                    // leaf-level: index of the feature, otherwise first entry of the level below
+
+    std::vector<int> num_children;
+  };
+
+  std::vector<Level> levels;
+
+  int node_size;
+
+  int num_features;
+
+
+  // 'Sort-Tile-Recursive' order of the entries [ sort by the x-center, split to vertical slices and sort each slice by the y-center ]
+  //
+
+  std::vector<int> str_order(const std::vector<double> &boxes) {
+
+    int n = boxes.size() / 4;
+
+    std::vector<int> order(n);
+
+    std::iota(order.begin(), order.end(), 0);
+
+    auto center_x = [&boxes](int i) { return boxes[4 * i] + boxes[4 * i + 2]; };
+
+    auto center_y = [&boxes](int i) { return boxes[4 * i + 1] + boxes[4 * i + 3]; };
+
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return center_x(a) < center_x(b); });
+
+    int num_nodes = (n + node_size - 1) / node_size;
+
+    int num_slices = std::ceil(std::sqrt(static_cast<double>(num_nodes)));
+
+    int slice_size = num_slices * node_size;
+
+    for (int start = 0; start < n; start += slice_size) {
+
+      int end = std::min(start + slice_size, n);
+
+      std::sort(order.begin() + start, order.begin() + end, [&](int a, int b) { return center_y(a) < center_y(b); });
+    }
+
+    return order;
+  }
+
+
+  // packs the entries of a level ( already in 'STR' order ) into the nodes of the next level
+  //
+
+  Level pack_level(const Level &lower) {
+
+    Level upper;
+
+    int n = lower.boxes.size() / 4;
+
+    for (int start = 0; start < n; start += node_size) {
+
+      int end = std::min(start + node_size, n);
+
+      double min_x = lower.boxes[4 * start], min_y = lower.boxes[4 * start + 1], max_x = lower.boxes[4 * start + 2], max_y = lower.boxes[4 * start + 3];
+
+      for (int i = start + 1; i < end; i++) {
+
+        min_x = std::min(min_x, lower.boxes[4 * i]);
+
+        min_y = std::min(min_y, lower.boxes[4 * i + 1]);
+
+        max_x = std::max(max_x, lower.boxes[4 * i + 2]);
+
+        max_y = std::max(max_y, lower.boxes[4 * i + 3]);
+      }
+
+      upper.boxes.insert(upper.boxes.end(), {min_x, min_y, max_x, max_y});
+
+      upper.first_child.push_back(start);
+
+      upper.num_children.push_back(end - start);
+    }
+
+    return upper;
+  }
+
+
+  // reorders the entries of a level
+  //
+
+  Level reorder_level(const Level &lev, const std::vector<int> &order) {
+
+    Level out;
+
+    out.boxes.reserve(lev.boxes.size());
+
+    for (int idx : order) {
+
+      out.boxes.insert(out.boxes.end(), lev.boxes.begin() + 4 * idx, lev.boxes.begin() + 4 * idx + 4);
+
+      out.first_child.push_back(lev.first_child[idx]);
+
+      out.num_children.push_back(lev.num_children[idx]);
+    }
+
+    return out;
+  }
+
+
+public:
+
+  Packed_RTree(const std::vector<double> &feature_boxes, int num_feat, int node_size_ = 16) : node_size(std::max(node_size_, 2)), num_features(num_feat) {
+
+    Level leaves;                                                     // features without positions ( NaN bounding box ) are not indexed
+
+    for (int i = 0; i < num_feat; i++) {
+
+      const double *bx = &feature_boxes[4 * i];
+
+      if (std::isnan(bx[0]) || std::isnan(bx[1]) || std::isnan(bx[2]) || std::isnan(bx[3])) continue;
+
+      leaves.boxes.insert(leaves.boxes.end(), bx, bx + 4);
+
+      leaves.first_child.push_back(i);
+
+      leaves.num_children.push_back(0);
+    }
+
+    if (leaves.first_child.empty()) return;
+
+    levels.push_back(reorder_level(leaves, str_order(leaves.boxes)));
+
+    while (levels.back().first_child.size() > 1) {
+
+      Level upper = pack_level(levels.back());
+
+      if (upper.first_child.size() > 1) {
+
+        upper = reorder_level(upper, str_order(upper.boxes));        // the children ranges are kept, thus the nodes of the upper levels can be reordered as well
+      }
+
+      levels.push_back(std::move(upper));
+    }
+  }
+
+
+  // indices ( 0-based, sorted ) of the features whose bounding box intersects the query-box
+  //
+
+  std::vector<int> query(double min_x, double min_y, double max_x, double max_y) const {
+
+    std::vector<int> res;
+
+    if (levels.empty()) return res;
+
+    std::vector<std::pair<int, int> > stack;                          // ( level, entry )
+
+    stack.push_back(std::make_pair(static_cast<int>(levels.size()) - 1, 0));
+
+    while (!stack.empty()) {
+
+      std::pair<int, int> item = stack.back();
+
+      stack.pop_back();
+
+      const Level &lev = levels[item.first];
+
+      const double *bx = &lev.boxes[4 * item.second];
+
+      if (bx[0] > max_x || bx[2] < min_x || bx[1] > max_y || bx[3] < min_y) continue;
+
+      if (item.first == 0) {
+
+        res.push_back(lev.first_child[item.second]);}
+
+      else {
+
+        for (int c = 0; c < lev.num_children[item.second]; c++) {
+
+          stack.push_back(std::make_pair(item.first - 1, lev.first_child[item.second] + c));
+        }
+      }
+    }
+
+    std::sort(res.begin(), res.end());
+
+    return res;
+  }
+
+
+  int size() const { return num_features; }
+
+  ~Packed_RTree() { }
+};
+
+
+
+// external pointer of the R-tree [ it becomes NULL if the object was saved and restored in a new R session ]
+//
+
+Packed_RTree *get_RTree(SEXP layer) {
+
+  Rcpp::XPtr<Packed_RTree> ptr(layer);
+
+  Packed_RTree *tree = ptr.get();
+
+  if (tree == NULL) {
+
+    Rcpp::stop("the spatial index is not valid ( external pointers can not be saved and restored between R sessions ). Re-build the index using the 'spatial_index' function!");
+  }
+
+  return tree;
+}
+
+
+// 0-based indices to R's 1-based integer vector
+//
+
+Rcpp::IntegerVector query_output(const std::vector<int> &idx) {
+
+  Rcpp::IntegerVector res(idx.size());
+
+  for (unsigned int i = 0; i < idx.size(); i++) {
+
+    res[i] = idx[i] + 1;
+  }
+
+  return res;
+}
+
+
+
+//========================
+// Rcpp-exported functions
+//========================
+
+
+// build the packed R-tree from an N x 4 matrix of bounding boxes ( xmin, ymin, xmax, ymax )
+//
+
+// [[Rcpp::export]]
+SEXP export_spatial_index(Rcpp::NumericMatrix feature_bbox, int node_size = 16) {
+
+  int num_feat = feature_bbox.nrow();
+
+  std::vector<double> boxes(4 * num_feat);
+
+  for (int i = 0; i < num_feat; i++) {
+
+    for (int j = 0; j < 4; j++) {
+
+      boxes[4 * i + j] = feature_bbox(i, j);
+    }
+  }
+
+  Rcpp::XPtr<Packed_RTree> ptr(new Packed_RTree(boxes, num_feat, node_size), true);
+
+  return ptr;
+}
+
+
+// features whose bounding box intersects 'bbox'
+//
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector export_query_bbox(SEXP layer, std::vector<double> bbox) {
+
+  Packed_RTree *tree = get_RTree(layer);
+
+  return query_output(tree->query(bbox[0], bbox[1], bbox[2], bbox[3]));
+}
+
+
+// features whose bounding box includes the point ( x, y )
+//
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector export_query_point(SEXP layer, double x, double y) {
+
+  Packed_RTree *tree = get_RTree(layer);
+
+  return query_output(tree->query(x, y, x, y));
+}
+
@@ -0,0 +1,458 @@
+
+/**
+ * Copyright (C) 2017 Lampros Mouselimis
+ *
+ * @file splice_features.h
+ *
+ * @Notes: validation of the top-level structure of a 'Feature' ( a json object with "type": "Feature" ) without building a json11 object, so that the raw
+ *         bytes of the Feature files can be copied to the output FeatureCollection. The bounding box of the "geometry" is optionally computed by scanning only
+ *         the numbers of the "coordinates". It does not use the R API, thus it can be called from multiple threads
+ *
+ **/
+
+
+#pragma once
+
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <limits>
+#include <algorithm>
+
+
+// validated Feature [ 'begin' and 'length' exclude the surrounding white-space ]
+//
+
+struct Splice_Feature {
+
+  std::string data;
+
+  size_t begin, length;
+
+  double bbox[4];                                           // xmin, ymin, xmax, ymax ( infinite if the geometry has no positions )
+
+  std::string error;
+
+  Splice_Feature() : begin(0), length(0) {
+
+    bbox[0] = bbox[1] = std::numeric_limits<double>::infinity();
+
+    bbox[2] = bbox[3] = -std::numeric_limits<double>::infinity();
+  }
+};
+
+
+class Feature_Scanner {
+
+private:
+
+  const char *p, *end;
+
+  double *bbox;                                             // NULL : the coordinates are not scanned
+
+  const char *error;
+
+  static const int max_depth = 200;                         // the same limit as the 'json11' parser
+
+
+  bool fail(const char *message) {
+
+    if (error == NULL) error = message;
+
+    return false;
+  }
+
+
+  void skip_ws() {
+
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+  }
+
+
+  // 'p' points to the opening quote. The content of the string ( without the quotes ) is returned in 'str' and 'len'
+  //
+
+  bool scan_string(const char *&str, size_t &len) {
+
+    str = ++p;
+
+    while (p < end && *p != '"') {
+
+      if (*p == '\\') p++;
+
+      p++;
+    }
+
+    if (p >= end) return fail("unterminated string");
+
+    len = p - str;
+
+    p++;
+
+    return true;
+  }
+
+
+  // number, true, false or null
+  //
+
+  bool scan_literal() {
+
+    const char *start = p;
+
+    while (p < end && (std::isalnum(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' || *p == '.')) p++;
+
+    return (p > start) ? true : fail("invalid json value");
+  }
+
+
+  // array of the "coordinates" : the first two numbers of the innermost arrays ( positions ) update the bounding box
+  //
+
+  bool scan_coordinates(int depth) {
+
+    if (depth > max_depth) return fail("exceeded the maximum nesting depth");
+
+    p++;
+
+    skip_ws();
+
+    int idx = 0;
+
+    double x = 0.0;
+
+    if (p < end && *p == ']') {
+
+      p++;
+
+      return true;
+    }
+
+    while (p < end) {
+
+      skip_ws();
+
+      if (p >= end) break;
+
+      if (*p == '[') {
+
+        if (!scan_coordinates(depth + 1)) return false;}
+
+      else {
+
+        char *num_end;
+
+        double value = std::strtod(p, &num_end);                        // the data are null-terminated ( std::string )
+
+        if (num_end == p) return fail("the coordinates should be numbers");
+
+        p = num_end;
+
+        if (idx == 0) {
+
+          x = value;}
+
+        else if (idx == 1) {
+
+          bbox[0] = std::min(bbox[0], x);
+
+          bbox[1] = std::min(bbox[1], value);
+
+          bbox[2] = std::max(bbox[2], x);
+
+          bbox[3] = std::max(bbox[3], value);
+        }
+
+        idx++;
+      }
+
+      skip_ws();
+
+      if (p < end && *p == ',') {
+
+        p++;
+
+        continue;
+      }
+
+      if (p < end && *p == ']') {
+
+        p++;
+
+        return true;
+      }
+
+      return fail("expected ',' or ']' in an array");
+    }
+
+    return fail("unterminated array");
+  }
+
+
+  // any json value. If 'coords' is true then the value is the "coordinates" member of a geometry
+  //
+
+  bool scan_value(int depth, bool coords) {
+
+    if (depth > max_depth) return fail("exceeded the maximum nesting depth");
+
+    skip_ws();
+
+    if (p >= end) return fail("unexpected end of input");
+
+    if (*p == '"') {
+
+      const char *str;
+
+      size_t len;
+
+      return scan_string(str, len);
+    }
+
+    if (*p == '[') {
+
+      if (coords && bbox != NULL) return scan_coordinates(depth + 1);
+
+      p++;
+
+      skip_ws();
+
+      if (p < end && *p == ']') {
+
+        p++;
+
+        return true;
+      }
+
+      while (p < end) {
+
+        if (!scan_value(depth + 1, false)) return false;
+
+        skip_ws();
+
+        if (p < end && *p == ',') {
+
+          p++;
+
+          continue;
+        }
+
+        if (p < end && *p == ']') {
+
+          p++;
+
+          return true;
+        }
+
+        return fail("expected ',' or ']' in an array");
+      }
+
+      return fail("unterminated array");
+    }
+
+    if (*p == '{') {
+
+      p++;
+
+      skip_ws();
+
+      if (p < end && *p == '}') {
+
+        p++;
+
+        return true;
+      }
+
+      while (p < end) {
+
+        skip_ws();
+
+        if (p >= end || *p != '"') return fail("expected a string key in an object");
+
+        const char *key;
+
+        size_t len;
+
+        if (!scan_string(key, len)) return false;
+
+        skip_ws();
+
+        if (p >= end || *p != ':') return fail("expected ':' in an object");
+
+        p++;
+
+        bool is_coords = (len == 11 && std::strncmp(key, "coordinates", 11) == 0);     // the "coordinates" of a geometry ( or of the items of a "GeometryCollection" )
+
+        if (!scan_value(depth + 1, is_coords)) return false;
+
+        skip_ws();
+
+        if (p < end && *p == ',') {
+
+          p++;
+
+          continue;
+        }
+
+        if (p < end && *p == '}') {
+
+          p++;
+
+          return true;
+        }
+
+        return fail("expected ',' or '}' in an object");
+      }
+
+      return fail("unterminated object");
+    }
+
+    return scan_literal();
+  }
+
+
+public:
+
+  Feature_Scanner() : p(NULL), end(NULL), bbox(NULL), error(NULL) { }
+
+
+  // validates the Feature of 'feat.data' and sets the position of the Feature in the data. The members of the Feature are scanned ( a single pass ), but
+  // only the "type" is checked. If 'compute_bbox' is true then the bounding box of the "geometry" is computed as well
+  //
+
+  bool validate(Splice_Feature &feat, bool compute_bbox) {
+
+    p = feat.data.data();
+
+    end = p + feat.data.size();
+
+    error = NULL;
+
+    if (end - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;          // UTF-8 byte order mark
+
+    skip_ws();
+
+    if (p >= end || *p != '{') {
+
+      feat.error = "the file does not include a json object";
+
+      return false;
+    }
+
+    feat.begin = p - feat.data.data();
+
+    p++;
+
+    bool is_feature = false;
+
+    skip_ws();
+
+    if (p < end && *p == '}') {
+
+      p++;}
+
+    else {
+
+      while (true) {
+
+        skip_ws();
+
+        if (p >= end || *p != '"') {
+
+          fail("expected a string key in an object");
+
+          break;
+        }
+
+        const char *key;
+
+        size_t len;
+
+        if (!scan_string(key, len)) break;
+
+        skip_ws();
+
+        if (p >= end || *p != ':') {
+
+          fail("expected ':' in an object");
+
+          break;
+        }
+
+        p++;
+
+        skip_ws();
+
+        if (len == 4 && std::strncmp(key, "type", 4) == 0 && p < end && *p == '"') {
+
+          const char *value;
+
+          size_t value_len;
+
+          if (!scan_string(value, value_len)) break;
+
+          is_feature = (value_len == 7 && std::strncmp(value, "Feature", 7) == 0);}
+
+        else {
+
+          bbox = (compute_bbox && len == 8 && std::strncmp(key, "geometry", 8) == 0) ? feat.bbox : NULL;
+
+          bool valid = scan_value(1, false);
+
+          bbox = NULL;
+
+          if (!valid) break;
+        }
+
+        skip_ws();
+
+        if (p < end && *p == ',') {
+
+          p++;
+
+          continue;
+        }
+
+        if (p < end && *p == '}') {
+
+          p++;
+
+          break;
+        }
+
+        fail("expected ',' or '}' in an object");
+
+        break;
+      }
+    }
+
+    if (error != NULL) {
+
+      feat.error = error;
+
+      return false;
+    }
+
+    feat.length = (p - feat.data.data()) - feat.begin;
+
+    skip_ws();
+
+    if (p != end) {
+
+      feat.error = "the file includes data after the end of the json object";
+
+      return false;
+    }
+
+    if (!is_feature) {
+
+      feat.error = "the json object is not a 'Feature' ( \"type\": \"Feature\" )";
+
+      return false;
+    }
+
+    return true;
+  }
+};
+